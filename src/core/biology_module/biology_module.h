@@ -16,6 +16,7 @@
 #define CORE_BIOLOGY_MODULE_BIOLOGY_MODULE_H_
 
 #include "core/event/event.h"
+#include "core/memory/memory_manager.h"
 #include "core/sim_object/sim_object.h"
 #include "core/util/type.h"
 
@@ -56,6 +57,19 @@ struct BaseBiologyModule {
 
   virtual ~BaseBiologyModule() {}
 
+  /// Biology modules are allocated on the NUMA node of the calling thread
+  /// (see `MemoryManager`).
+  static void* operator new(std::size_t size) {
+    return MemoryManager::GetInstance()->New(size);
+  }
+
+  /// Placement new (e.g. used by ROOT I/O)
+  static void* operator new(std::size_t size, void* where) { return where; }
+
+  static void operator delete(void* p, std::size_t size) {
+    MemoryManager::GetInstance()->Delete(p, size);
+  }
+
   /// Create a new instance of this object using the default constructor.
   virtual BaseBiologyModule* GetInstance(const Event& event,
                                          BaseBiologyModule* other,
@@ -69,6 +83,11 @@ struct BaseBiologyModule {
 
   virtual void Run(SimObject* so) = 0;
 
+  /// Wake condition of a dormant simulation object (see `SimObject::Sleep`).
+  /// Evaluated in each simulation step while `so` is dormant. If it returns
+  /// true, `so` wakes up and is processed again in this step.
+  virtual bool WakeUp(const SimObject* so) const { return false; }
+
   /// Function returns whether the biology module should be copied for the
   /// given event.
   bool Copy(EventId event) const { return (event & copy_mask_) != 0; }
@@ -50,6 +50,20 @@ class SimObjectVector {
     }
   }
 
+  /// Resizes the storage such that it can hold N instances of type T (N being
+  /// the number of simulation objects in each numa domain).
+  /// In contrast to `reserve`, elements that are still in range keep their
+  /// value and new elements are value initialized.
+  void resize() {  // NOLINT
+    auto* sim = Simulation::GetActive();
+    auto* rm = sim->GetResourceManager();
+    for (int n = 0; n < thread_info_->GetNumaNodes(); n++) {
+      auto num_sos = rm->GetNumSimObjects(n);
+      data_[n].resize(num_sos);
+      size_[n] = num_sos;
+    }
+  }
+
   void clear() {  // NOLINT
     for (auto& el : size_) {
       el = 0;
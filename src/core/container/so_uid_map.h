@@ -0,0 +1,148 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef CORE_CONTAINER_SO_UID_MAP_H_
+#define CORE_CONTAINER_SO_UID_MAP_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "core/sim_object/so_uid.h"
+
+namespace bdm {
+
+/// Map from `SoUid` to `TValue` that stores the values in a vector indexed
+/// by the uid. Since `SoUidGenerator` hands out consecutive uids, lookups are
+/// a single array access.\n
+/// The vector only covers the uids in the range [GetFirstUid(), size()).
+/// `SoUidGenerator` is global and never reset; the offset avoids that the map
+/// of a simulation allocates entries for the uids of earlier simulations.
+/// `Compact` releases the entries of removed uids at both ends of the range.\n
+/// A default constructed `TValue` marks an empty entry; it can therefore not
+/// be stored as a value.\n
+/// `Insert` and `Remove` are thread safe for different uids as long as the
+/// map is not resized at the same time.
+template <typename TValue>
+class SoUidMap {
+ public:
+  SoUidMap() {}
+
+  explicit SoUidMap(uint64_t initial_size) : data_(initial_size) {}
+
+  /// Grows the map such that it can hold uids in the range
+  /// [GetFirstUid(), new_size). Never shrinks the map. New entries are empty.
+  void resize(uint64_t new_size) {  // NOLINT
+    if (new_size > size()) {
+      data_.resize(new_size - first_uid_);
+    }
+  }
+
+  /// Grows the map such that it can also hold uids in the range
+  /// [first_uid, GetFirstUid()). New entries are empty.
+  void ReserveFrom(SoUid first_uid) {
+    if (first_uid >= first_uid_) {
+      return;
+    }
+    if (data_.empty()) {
+      first_uid_ = first_uid;
+      return;
+    }
+    data_.insert(data_.begin(), first_uid_ - first_uid, TValue());
+    first_uid_ = first_uid;
+  }
+
+  /// Removes the empty entries in front of the smallest and after the largest
+  /// stored uid and releases their memory. If the map does not contain any
+  /// value, it restarts at `next_uid`.
+  void Compact(SoUid next_uid) {
+    uint64_t begin = 0;
+    while (begin < data_.size() && data_[begin] == TValue()) {
+      begin++;
+    }
+    if (begin == data_.size()) {
+      clear(next_uid);
+      return;
+    }
+    uint64_t end = data_.size();
+    while (data_[end - 1] == TValue()) {
+      end--;
+    }
+    if (begin != 0) {
+      std::copy(data_.begin() + begin, data_.begin() + end, data_.begin());
+    }
+    data_.resize(end - begin);
+    data_.shrink_to_fit();
+    first_uid_ += begin;
+  }
+
+  /// Removes all entries. Subsequent uids are stored relative to `first_uid`.
+  void clear(SoUid first_uid = 0) {  // NOLINT
+    data_.clear();
+    data_.shrink_to_fit();
+    first_uid_ = first_uid;
+  }
+
+  /// Returns the smallest uid that can be stored without resizing
+  SoUid GetFirstUid() const { return first_uid_; }
+
+  /// Returns the smallest uid larger than `GetFirstUid()` that can not be
+  /// stored without resizing
+  uint64_t size() const { return first_uid_ + data_.size(); }  // NOLINT
+
+  /// Returns the number of allocated entries
+  uint64_t capacity() const { return data_.size(); }  // NOLINT
+
+  /// NB: `uid` must be in the range [GetFirstUid(), size())
+  void Insert(SoUid uid, const TValue& value) {
+    assert(InRange(uid) && "SoUidMap::Insert: uid out of range");
+    data_[uid - first_uid_] = value;
+  }
+
+  void Remove(SoUid uid) {
+    if (InRange(uid)) {
+      data_[uid - first_uid_] = TValue();
+    }
+  }
+
+  bool Contains(SoUid uid) const {
+    return InRange(uid) && data_[uid - first_uid_] != TValue();
+  }
+
+  /// Returns the value of the given uid, or a default constructed `TValue`
+  /// if the map does not contain it.
+  TValue Get(SoUid uid) const {
+    return InRange(uid) ? data_[uid - first_uid_] : TValue();
+  }
+
+  /// NB: the map must contain `uid`
+  const TValue& operator[](SoUid uid) const {
+    assert(InRange(uid) && "SoUidMap::operator[]: uid out of range");
+    return data_[uid - first_uid_];
+  }
+
+ private:
+  std::vector<TValue> data_;
+  /// Uid of `data_[0]`
+  SoUid first_uid_ = 0;
+
+  bool InRange(SoUid uid) const {
+    return uid >= first_uid_ && uid - first_uid_ < data_.size();
+  }
+};
+
+}  // namespace bdm
+
+#endif  // CORE_CONTAINER_SO_UID_MAP_H_
@@ -81,6 +81,10 @@ void DefaultForce::ForceBetweenSpheres(const SimObject* sphere_lhs,
   double comp1 = c1[0] - c2[0];
   double comp2 = c1[1] - c2[1];
   double comp3 = c1[2] - c2[2];
+  // use the closest periodic image of c2 if periodic boundaries are used
+  comp1 = Math::MinimumImage(comp1, periodic_length_);
+  comp2 = Math::MinimumImage(comp2, periodic_length_);
+  comp3 = Math::MinimumImage(comp3, periodic_length_);
   double center_distance =
       std::sqrt(comp1 * comp1 + comp2 * comp2 + comp3 * comp3);
   // the overlap distance (how much one penetrates in the other)
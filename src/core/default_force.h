@@ -25,7 +25,12 @@ class SimObject;
 
 class DefaultForce {
  public:
-  DefaultForce() {}
+  /// @param periodic_length length of the simulation space if periodic
+  ///        boundaries are used (see `Grid::GetPeriodicLength`). The force
+  ///        between two spheres is then calculated for the closest periodic
+  ///        image.
+  explicit DefaultForce(double periodic_length = 0)
+      : periodic_length_(periodic_length) {}
   ~DefaultForce() {}
   DefaultForce(const DefaultForce&) = delete;
   DefaultForce& operator=(const DefaultForce&) = delete;
@@ -49,6 +54,8 @@ class DefaultForce {
 
   Double4 ComputeForceOfASphereOnASphere(const Double3& c1, double r1,
                                          const Double3& c2, double r2) const;
+
+  double periodic_length_ = 0;
 };
 
 }  // namespace bdm
@@ -16,6 +16,7 @@
 #define CORE_DIFFUSION_GRID_H_
 
 #include <assert.h>
+#include <omp.h>
 
 #include <algorithm>
 #include <array>
@@ -23,6 +24,7 @@
 #include <functional>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 #include "core/util/root.h"
 
@@ -38,6 +40,10 @@ namespace bdm {
 /// It maintains the concentration and gradient of a single substance
 class DiffusionGrid {
  public:
+  /// Numerical methods to solve the diffusion equation
+  /// (see `Param::diffusion_method_`)
+  enum DiffusionMethod { kEuler = 1, kADI = 2 };
+
   explicit DiffusionGrid(TRootIOCtor* p) {}
   DiffusionGrid(int substance_id, std::string substance_name, double dc,
                 double mu, int resolution = 11)
@@ -94,12 +100,20 @@ class DiffusionGrid {
     c2_.resize(total_num_boxes_);
     gradients_.resize(3 * total_num_boxes_);
 
+    secretion_buffers_.resize(omp_get_max_threads());
+    InitializeBricks();
+
     initialized_ = true;
   }
 
   void ParametersCheck() {
+    // The implicit method is unconditionally stable
+    if (diffusion_method_ == kADI) {
+      return;
+    }
     // The 1.0 is to impose floating point operations
-    if ((1.0 * (1 - dc_[0]) * dt_) / (1.0 * box_length_ * box_length_) >=
+    if ((1.0 * (1 - dc_[0]) * substep_dt_) /
+            (1.0 * box_length_ * box_length_) >=
         (1.0 / 6)) {
       Log::Fatal(
           "DiffusionGrid",
@@ -107,7 +121,8 @@ class DiffusionGrid {
           substance_name_,
           "] will result in unphysical behavior (diffusion coefficient = ",
           (1 - dc_[0]), ", resolution = ", resolution_,
-          "). Please refer to the user guide for more information.");
+          "). Please refer to the user guide for more information or use "
+          "the diffusion method \"adi\".");
     }
   }
 
@@ -211,6 +226,7 @@ class DiffusionGrid {
           num_boxes_axis_[0] * num_boxes_axis_[1] * num_boxes_axis_[2];
 
       CopyOldData(tmp_c1, tmp_gradients, tmp_num_boxes_axis);
+      InitializeBricks();
 
       assert(total_num_boxes_ >= tmp_num_boxes_axis[0] * tmp_num_boxes_axis[1] *
                                      tmp_num_boxes_axis[2] &&
@@ -349,6 +365,7 @@ class DiffusionGrid {
       }    // tile nz
     }      // block ny
     c1_.swap(c2_);
+    PropagateBricks(1);
   }
 
   /// Solves a 5-point stencil diffusion equation, with closed-edge
@@ -406,6 +423,7 @@ class DiffusionGrid {
       }    // tile nz
     }      // block ny
     c1_.swap(c2_);
+    PropagateBricks(1);
   }
 
   void DiffuseEuler() {
@@ -414,13 +432,15 @@ class DiffusionGrid {
     if (IsFixedSubstance()) {
       return;
     }
+    if (sparse_) {
+      DiffuseEulerSparse(false);
+      return;
+    }
 
-    const auto nx = num_boxes_axis_[0];
     const auto ny = num_boxes_axis_[1];
     const auto nz = num_boxes_axis_[2];
-
-    const double ibl2 = 1 / (box_length_ * box_length_);
-    const double d = 1 - dc_[0];
+    const double* c1 = c1_.data();
+    double* c2 = c2_.data();
 
 #define YBF 16
 #pragma omp parallel for collapse(2)
@@ -431,36 +451,7 @@ class DiffusionGrid {
           ymax = ny;
         }
         for (size_t y = yy; y < ymax; y++) {
-          size_t x = 0;
-          int c, n, s, b, t;
-          c = x + y * nx + z * nx * ny;
-#pragma omp simd
-          for (x = 1; x < nx - 1; x++) {
-            ++c;
-            ++n;
-            ++s;
-            ++b;
-            ++t;
-
-            if (y == 0 || y == (ny - 1) || z == 0 || z == (nz - 1)) {
-              continue;
-            }
-
-            n = c - nx;
-            s = c + nx;
-            b = c - nx * ny;
-            t = c + nx * ny;
-            c2_[c] = (c1_[c] +
-                      d * dt_ * (c1_[c - 1] - 2 * c1_[c] + c1_[c + 1]) * ibl2 +
-                      d * dt_ * (c1_[s] - 2 * c1_[c] + c1_[n]) * ibl2 +
-                      d * dt_ * (c1_[b] - 2 * c1_[c] + c1_[t]) * ibl2) *
-                     (1 - mu_);
-          }
-          ++c;
-          ++n;
-          ++s;
-          ++b;
-          ++t;
+          DiffuseEulerRow(c1, c2, y, z);
         }  // tile ny
       }    // tile nz
     }      // block ny
@@ -473,14 +464,15 @@ class DiffusionGrid {
     if (IsFixedSubstance()) {
       return;
     }
+    if (sparse_) {
+      DiffuseEulerSparse(true);
+      return;
+    }
 
-    const auto nx = num_boxes_axis_[0];
     const auto ny = num_boxes_axis_[1];
     const auto nz = num_boxes_axis_[2];
-
-    const double ibl2 = 1 / (box_length_ * box_length_);
-    const double d = 1 - dc_[0];
-    std::array<int, 4> l;
+    const double* c1 = c1_.data();
+    double* c2 = c2_.data();
 
 #define YBF 16
 #pragma omp parallel for collapse(2)
@@ -491,72 +483,180 @@ class DiffusionGrid {
           ymax = ny;
         }
         for (size_t y = yy; y < ymax; y++) {
-          size_t x = 0;
-          int c, n, s, b, t;
-          c = x + y * nx + z * nx * ny;
+          DiffuseEulerLeakingEdgeRow(c1, c2, y, z);
+        }  // tile ny
+      }    // tile nz
+    }      // block ny
+    c1_.swap(c2_);
+  }
 
-          l.fill(1);
+  /// Performs one step of `DiffuseEuler` (or `DiffuseEulerLeakingEdge` if
+  /// `leaking_edges` is true) only for the bricks that contain, or are next
+  /// to a brick that contains, a non-negligible concentration
+  /// (see `SetSparse`). The other bricks remain zero.
+  void DiffuseEulerSparse(bool leaking_edges) {
+    if (IsFixedSubstance()) {
+      return;
+    }
+    if (c1_zero_bricks_.size() != GetNumBricks()) {
+      InitializeBricks();
+    }
 
-          if (y == 0) {
-            n = c;
-            l[0] = 0;
-          } else {
-            n = c - nx;
+    const size_t nx = num_boxes_axis_[0];
+    const size_t ny = num_boxes_axis_[1];
+    const size_t nz = num_boxes_axis_[2];
+    const size_t nbx = num_bricks_axis_[0];
+    const size_t nby = num_bricks_axis_[1];
+    const size_t nbz = num_bricks_axis_[2];
+    const size_t bl = kBrickLength;
+    const double* c1 = c1_.data();
+    double* c2 = c2_.data();
+    const uint8_t* src_zero = c1_zero_bricks_.data();
+    uint8_t* dst_zero = c2_zero_bricks_.data();
+
+#pragma omp parallel for collapse(3) schedule(dynamic, 1)
+    for (size_t bz = 0; bz < nbz; bz++) {
+      for (size_t by = 0; by < nby; by++) {
+        for (size_t bx = 0; bx < nbx; bx++) {
+          size_t brick = bz * nbx * nby + by * nbx + bx;
+          // the result would be zero, which dst already is
+          if (dst_zero[brick] && IsZeroNeighborhood(src_zero, bx, by, bz)) {
+            continue;
           }
-
-          if (y == ny - 1) {
-            s = c;
-            l[1] = 0;
-          } else {
-            s = c + nx;
+          size_t x_end = std::min(bx * bl + bl, nx);
+          size_t y_end = std::min(by * bl + bl, ny);
+          size_t z_end = std::min(bz * bl + bl, nz);
+          for (size_t z = bz * bl; z < z_end; z++) {
+            for (size_t y = by * bl; y < y_end; y++) {
+              if (leaking_edges) {
+                DiffuseEulerLeakingEdgeRow(c1, c2, y, z, bx * bl, x_end);
+              } else {
+                DiffuseEulerRow(c1, c2, y, z, bx * bl, x_end);
+              }
+            }
           }
+          dst_zero[brick] = TruncateBrick(c2, bx, by, bz);
+        }
+      }
+    }
+    c1_.swap(c2_);
+    c1_zero_bricks_.swap(c2_zero_bricks_);
+  }
 
-          if (z == 0) {
-            b = c;
-            l[2] = 0;
-          } else {
-            b = c - nx * ny;
-          }
+  /// Performs `steps` diffusion steps with `DiffuseEuler`, or with
+  /// `DiffuseEulerLeakingEdge` if `leaking_edges` is true. The results are
+  /// the same as if these functions were called `steps` times.\n
+  /// Instead of one sweep over the whole grid per step, up to `time_block`
+  /// steps are advanced in one wavefront along the z-axis: step t + 1 of a
+  /// plane is calculated two planes behind step t, once all its neighbors
+  /// of step t are available. The planes of the wavefront stay in the cache,
+  /// so the concentrations are loaded from main memory only once per
+  /// `time_block` steps. All rows of the steps in the wavefront are
+  /// processed in parallel.
+  void DiffuseEulerTimeBlocked(uint64_t steps, bool leaking_edges,
+                               uint64_t time_block = 8) {
+    // check if diffusion coefficient and decay constant are 0
+    // i.e. if we don't need to calculate diffusion update
+    if (IsFixedSubstance()) {
+      return;
+    }
 
-          if (z == nz - 1) {
-            t = c;
-            l[3] = 0;
-          } else {
-            t = c + nx * ny;
+    const uint64_t num_steps = steps;
+    const size_t ny = num_boxes_axis_[1];
+    const size_t nz = num_boxes_axis_[2];
+    // Distance in planes between consecutive steps of a wavefront.
+    // Step t of plane z reads the results of step t - 1 of planes z - 1 to
+    // z + 1. It overwrites the result of step t - 2 of plane z, which
+    // step t - 1 of planes z - 1 to z + 1 has read. With a distance of two,
+    // all of them belong to earlier wavefronts.
+    constexpr size_t kSkew = 2;
+
+    while (steps > 0) {
+      uint64_t block = std::min(steps, time_block);
+      // step t reads from buffers[t % 2] and writes to buffers[(t + 1) % 2]
+      double* buffers[2] = {c1_.data(), c2_.data()};
+      size_t num_wavefronts = nz + kSkew * (block - 1);
+
+#pragma omp parallel
+      for (size_t w = 0; w < num_wavefronts; w++) {
+#pragma omp for collapse(2) schedule(static)
+        for (uint64_t t = 0; t < block; t++) {
+          for (size_t y = 0; y < ny; y++) {
+            if (w < kSkew * t || w - kSkew * t >= nz) {
+              continue;
+            }
+            size_t z = w - kSkew * t;
+            const double* src = buffers[t % 2];
+            double* dst = buffers[(t + 1) % 2];
+            if (leaking_edges) {
+              DiffuseEulerLeakingEdgeRow(src, dst, y, z);
+            } else {
+              DiffuseEulerRow(src, dst, y, z);
+            }
           }
+        }
+      }
 
-          c2_[c] = (c1_[c] + d * dt_ * (0 - 2 * c1_[c] + c1_[c + 1]) * ibl2 +
-                    d * dt_ * (c1_[s] - 2 * c1_[c] + c1_[n]) * ibl2 +
-                    d * dt_ * (c1_[b] - 2 * c1_[c] + c1_[t]) * ibl2) *
-                   (1 - mu_);
-#pragma omp simd
-          for (x = 1; x < nx - 1; x++) {
-            ++c;
-            ++n;
-            ++s;
-            ++b;
-            ++t;
-            c2_[c] =
-                (c1_[c] +
-                 d * dt_ * (c1_[c - 1] - 2 * c1_[c] + c1_[c + 1]) * ibl2 +
-                 d * dt_ * (l[0] * c1_[s] - 2 * c1_[c] + l[1] * c1_[n]) * ibl2 +
-                 d * dt_ * (l[2] * c1_[b] - 2 * c1_[c] + l[3] * c1_[t]) *
-                     ibl2) *
-                (1 - mu_);
-          }
-          ++c;
-          ++n;
-          ++s;
-          ++b;
-          ++t;
-          c2_[c] = (c1_[c] + d * dt_ * (c1_[c - 1] - 2 * c1_[c] + 0) * ibl2 +
-                    d * dt_ * (c1_[s] - 2 * c1_[c] + c1_[n]) * ibl2 +
-                    d * dt_ * (c1_[b] - 2 * c1_[c] + c1_[t]) * ibl2) *
-                   (1 - mu_);
-        }  // tile ny
-      }    // tile nz
-    }      // block ny
-    c1_.swap(c2_);
+      if (block % 2 == 1) {
+        c1_.swap(c2_);
+      }
+      steps -= block;
+    }
+    PropagateBricks(num_steps);
+  }
+
+  /// Solves the diffusion equation with the alternating-direction implicit
+  /// method (ADI). The implicit Euler step is split into one tridiagonal
+  /// system per line along x, y and z, which are solved with the Thomas
+  /// algorithm. In contrast to `DiffuseEuler`, this method is stable for
+  /// any diffusion coefficient, box length and time step.\n
+  /// The lines along x are processed in parallel. Lines along y and z are
+  /// solved for a whole row of x values at once, so that the innermost loop
+  /// runs over contiguous memory.
+  ///
+  /// @param[in]  leaking_edges  If true, the concentration outside of the
+  ///                            grid is zero and substances leave the
+  ///                            simulation space. Otherwise the edges are
+  ///                            closed (zero flux).
+  void DiffuseADI(bool leaking_edges) {
+    // check if diffusion coefficient and decay constant are 0
+    // i.e. if we don't need to calculate diffusion update
+    if (IsFixedSubstance()) {
+      return;
+    }
+
+    const auto nx = num_boxes_axis_[0];
+    const auto ny = num_boxes_axis_[1];
+    const auto nz = num_boxes_axis_[2];
+    const double r = (1 - dc_[0]) * substep_dt_ / (box_length_ * box_length_);
+    double* c = c1_.data();
+
+    // x-direction; decay is applied to the right-hand side of the first
+    // system
+    auto coeff_x = ThomasCoefficients(nx, r, leaking_edges);
+#pragma omp parallel for collapse(2)
+    for (size_t z = 0; z < nz; z++) {
+      for (size_t y = 0; y < ny; y++) {
+        SolveTridiagonal(c + y * nx + z * nx * ny, nx, 1, 1, r, 1 - mu_,
+                         coeff_x);
+      }
+    }
+
+    // y-direction
+    auto coeff_y = ThomasCoefficients(ny, r, leaking_edges);
+#pragma omp parallel for
+    for (size_t z = 0; z < nz; z++) {
+      SolveTridiagonal(c + z * nx * ny, ny, nx, nx, r, 1, coeff_y);
+    }
+
+    // z-direction
+    auto coeff_z = ThomasCoefficients(nz, r, leaking_edges);
+#pragma omp parallel for
+    for (size_t y = 0; y < ny; y++) {
+      SolveTridiagonal(c + y * nx, nz, nx * ny, nx, r, 1, coeff_z);
+    }
+    // the implicit method spreads the substance over the whole grid
+    InitializeBricks();
   }
 
   /// Calculates the gradient for each box in the diffusion grid.
@@ -575,61 +675,116 @@ class DiffusionGrid {
       return;
     }
 
-    double gd = 1 / (box_length_ * 2);
-
-    auto nx = num_boxes_axis_[0];
     auto ny = num_boxes_axis_[1];
     auto nz = num_boxes_axis_[2];
+    const double* c1 = c1_.data();
 
 #pragma omp parallel for collapse(2)
     for (size_t z = 0; z < nz; z++) {
       for (size_t y = 0; y < ny; y++) {
-        for (size_t x = 0; x < nx; x++) {
-          int c, e, w, n, s, b, t;
-          c = x + y * nx + z * nx * ny;
+        CalculateGradientRow(c1, y, z);
+      }
+    }
+    if (!init_gradient_) {
+      init_gradient_ = true;
+    }
+  }
 
-          if (x == 0) {
-            e = c;
-            w = c + 2;
-          } else if (x == nx - 1) {
-            e = c - 2;
-            w = c;
-          } else {
-            e = c - 1;
-            w = c + 1;
-          }
+  /// Performs one diffusion step (`DiffuseEuler` or `DiffuseEulerLeakingEdge`)
+  /// and calculates the gradients (`CalculateGradient`) of several diffusion
+  /// grids in one sweep over the simulation space. The results are the same
+  /// as if the functions were called for each grid separately.\n
+  /// All grids must have the same number of boxes along each axis.\n
+  /// Each thread processes a slab of xy-planes. The gradient of a plane is
+  /// calculated right after the diffusion of the next plane, while the
+  /// concentrations are still in the cache. Only the gradients of the first
+  /// and last plane of each slab have to wait until all threads have
+  /// finished the diffusion step.
+  static void DiffuseAndCalculateGradients(
+      const std::vector<DiffusionGrid*>& grids, bool leaking_edges,
+      bool calculate_gradients) {
+    if (grids.empty()) {
+      return;
+    }
+    const auto ny = grids[0]->num_boxes_axis_[1];
+    const auto nz = grids[0]->num_boxes_axis_[2];
+    for (auto* grid : grids) {
+      assert(grid->num_boxes_axis_ == grids[0]->num_boxes_axis_ &&
+             "Fused diffusion requires grids with the same dimensions");
+    }
 
-          if (y == 0) {
-            n = c + 2 * nx;
-            s = c;
-          } else if (y == ny - 1) {
-            n = c;
-            s = c - 2 * nx;
-          } else {
-            n = c + nx;
-            s = c - nx;
-          }
+    // source of the new concentrations for the gradient calculation
+    // (c2_ until the buffers are swapped)
+    std::vector<const double*> concentrations(grids.size());
+    std::vector<bool> diffuse(grids.size());
+    std::vector<bool> gradient(grids.size());
+    for (size_t g = 0; g < grids.size(); g++) {
+      auto* grid = grids[g];
+      diffuse[g] = !grid->IsFixedSubstance();
+      gradient[g] = calculate_gradients &&
+                    !(grid->init_gradient_ && grid->IsFixedSubstance());
+      concentrations[g] = diffuse[g] ? grid->c2_.data() : grid->c1_.data();
+    }
 
-          if (z == 0) {
-            t = c + 2 * nx * ny;
-            b = c;
-          } else if (z == nz - 1) {
-            t = c;
-            b = c - 2 * nx * ny;
-          } else {
-            t = c + nx * ny;
-            b = c - nx * ny;
+    auto calculate_gradient = [&](size_t z) {
+      for (size_t g = 0; g < grids.size(); g++) {
+        if (gradient[g]) {
+          for (size_t y = 0; y < ny; y++) {
+            grids[g]->CalculateGradientRow(concentrations[g], y, z);
           }
+        }
+      }
+    };
+
+#pragma omp parallel
+    {
+      // static partitioning of the xy-planes
+      size_t num_threads = omp_get_num_threads();
+      size_t tid = omp_get_thread_num();
+      size_t chunk = nz / num_threads + (nz % num_threads == 0 ? 0 : 1);
+      size_t z_start = std::min(nz, tid * chunk);
+      size_t z_end = std::min(nz, z_start + chunk);
+
+      for (size_t z = z_start; z < z_end; z++) {
+        for (size_t g = 0; g < grids.size(); g++) {
+          if (!diffuse[g]) {
+            continue;
+          }
+          for (size_t y = 0; y < ny; y++) {
+            auto* grid = grids[g];
+            if (leaking_edges) {
+              grid->DiffuseEulerLeakingEdgeRow(grid->c1_.data(),
+                                               grid->c2_.data(), y, z);
+            } else {
+              grid->DiffuseEulerRow(grid->c1_.data(), grid->c2_.data(), y, z);
+            }
+          }
+        }
+        // planes z - 2, z - 1 and z are up to date
+        if (z >= z_start + 2) {
+          calculate_gradient(z - 1);
+        }
+      }
 
-          // Let the gradient point from low to high concentration
-          gradients_[3 * c + 0] = (c1_[w] - c1_[e]) * gd;
-          gradients_[3 * c + 1] = (c1_[n] - c1_[s]) * gd;
-          gradients_[3 * c + 2] = (c1_[t] - c1_[b]) * gd;
+#pragma omp barrier
+      // the first and last plane of a slab depend on other slabs
+      if (z_start < z_end) {
+        calculate_gradient(z_start);
+        if (z_end - 1 != z_start) {
+          calculate_gradient(z_end - 1);
         }
       }
     }
-    if (!init_gradient_) {
-      init_gradient_ = true;
+
+    for (size_t g = 0; g < grids.size(); g++) {
+      auto* grid = grids[g];
+      if (diffuse[g]) {
+        grid->c1_.swap(grid->c2_);
+        grid->PropagateBricks(1);
+      }
+      if (calculate_gradients) {
+        grid->init_gradient_ = true;
+      }
     }
   }
 
@@ -639,13 +794,87 @@ class DiffusionGrid {
     IncreaseConcentrationBy(idx, amount);
   }
 
-  /// Increase the concentration at specified box with specified amount
+  /// Increase the concentration at specified box with specified amount.\n
+  /// Inside a parallel region (e.g. in a biology module), the amount is added
+  /// to a buffer of the calling thread. Hence, threads that secrete into the
+  /// same box do not lose updates. Buffered amounts become visible after
+  /// `CommitSecretion`, which is called at the end of each iteration and by
+  /// `DiffusionOp` before each diffusion step.
   void IncreaseConcentrationBy(size_t idx, double amount) {
     assert(idx < total_num_boxes_ &&
            "Cell position is out of diffusion grid bounds");
-    c1_[idx] += amount;
-    if (c1_[idx] > concentration_threshold_) {
-      c1_[idx] = concentration_threshold_;
+    if (!omp_in_parallel()) {
+      AddConcentration(idx, amount);
+      return;
+    }
+    auto tid = static_cast<size_t>(omp_get_thread_num());
+    if (omp_get_level() > 1 || tid >= secretion_buffers_.size()) {
+      // Thread numbers of nested parallel regions are not unique, and the
+      // number of threads might have been increased after `Initialize`.
+#pragma omp critical(bdm_diffusion_grid_secretion)
+      AddConcentration(idx, amount);
+      return;
+    }
+    auto& buffer = secretion_buffers_[tid].data_;
+    // consecutive secretion into the same box is combined
+    if (!buffer.empty() && buffer.back().first == idx) {
+      buffer.back().second += amount;
+    } else {
+      buffer.emplace_back(idx, amount);
+    }
+  }
+
+  /// Adds the buffered secretion of all threads to the concentration
+  /// (see `IncreaseConcentrationBy`). The concentration threshold is applied
+  /// afterwards to the boxes that received secretion.
+  void CommitSecretion() {
+    // make sure that all threads of the next parallel region have a buffer
+    auto max_threads = static_cast<size_t>(omp_get_max_threads());
+    if (secretion_buffers_.size() < max_threads) {
+      secretion_buffers_.resize(max_threads);
+    }
+
+    bool empty = true;
+    for (auto& buffer : secretion_buffers_) {
+      empty &= buffer.data_.empty();
+    }
+    if (empty) {
+      return;
+    }
+
+    if (!c1_zero_bricks_.empty()) {
+      for (auto& buffer : secretion_buffers_) {
+        for (auto& el : buffer.data_) {
+          c1_zero_bricks_[GetBrickIndex(el.first)] = 0;
+        }
+      }
+    }
+
+    double* c1 = c1_.data();
+    auto num_buffers = secretion_buffers_.size();
+#pragma omp parallel for schedule(static, 1)
+    for (size_t t = 0; t < num_buffers; t++) {
+      auto& buffer = secretion_buffers_[t].data_;
+      for (auto& el : buffer) {
+#pragma omp atomic
+        c1[el.first] += el.second;
+      }
+    }
+
+    // several threads might have secreted into the same box
+#pragma omp parallel for schedule(static, 1)
+    for (size_t t = 0; t < num_buffers; t++) {
+      auto& buffer = secretion_buffers_[t].data_;
+      for (auto& el : buffer) {
+        double concentration;
+#pragma omp atomic read
+        concentration = c1[el.first];
+        if (concentration > concentration_threshold_) {
+#pragma omp atomic write
+          c1[el.first] = concentration_threshold_;
+        }
+      }
+      buffer.clear();
     }
   }
 
@@ -724,6 +953,66 @@ class DiffusionGrid {
 
   const std::array<double, 7>& GetDiffusionCoefficients() const { return dc_; }
 
+  /// Sets the time that is covered by one simulation step. It is split
+  /// evenly over the substeps (see `SetNumSubsteps`). Must be set before
+  /// `Initialize`, which checks the stability of the explicit method.
+  void SetTimeStep(double dt) {
+    dt_ = dt;
+    substep_dt_ = dt_ / num_substeps_;
+  }
+
+  double GetTimeStep() const { return dt_; }
+
+  /// Sets the number of diffusion steps per simulation step. Called by the
+  /// scheduler with `Param::diffusion_substeps_`; does not change the time
+  /// step set with `SetTimeStep`.
+  void SetNumSubsteps(uint64_t num_substeps) {
+    num_substeps_ = num_substeps;
+    substep_dt_ = dt_ / num_substeps_;
+  }
+
+  uint64_t GetNumSubsteps() const { return num_substeps_; }
+
+  /// Returns the time step of one diffusion step
+  double GetSubstepTimeStep() const { return substep_dt_; }
+
+  /// Divides the grid into bricks of `kBrickLength`^3 boxes and only
+  /// updates bricks with non-negligible concentrations, and their neighbors,
+  /// in `DiffuseEuler` and `DiffuseEulerLeakingEdge`.
+  /// Bricks whose concentrations are all below or equal to `threshold` are
+  /// set to zero. With the default threshold of zero, the results are the
+  /// same as without this option.\n
+  /// The concentrations are still stored in dense arrays; only the
+  /// computation is restricted to the active bricks. Allocating the bricks
+  /// on demand and different resolutions per axis are not supported yet.\n
+  /// The other Euler kernels keep the brick information up to date (see
+  /// `PropagateBricks`), so they can be mixed with the sparse one.
+  void SetSparse(bool sparse, double threshold = 0) {
+    sparse_ = sparse;
+    sparse_threshold_ = threshold;
+    InitializeBricks();
+  }
+
+  bool IsSparse() const { return sparse_; }
+
+  /// Returns the number of bricks that are known to be zero
+  /// (see `SetSparse`)
+  size_t GetNumZeroBricks() const {
+    return std::count(c1_zero_bricks_.begin(), c1_zero_bricks_.end(), 1);
+  }
+
+  /// Sets the numerical method used in `DiffusionOp`.
+  /// If the grid has already been initialized, the stability of the new
+  /// method is checked against the current parameters.
+  void SetDiffusionMethod(DiffusionMethod method) {
+    diffusion_method_ = method;
+    if (initialized_) {
+      ParametersCheck();
+    }
+  }
+
+  DiffusionMethod GetDiffusionMethod() const { return diffusion_method_; }
+
   bool IsInitialized() const { return initialized_; }
 
   int GetResolution() const { return resolution_; }
@@ -742,6 +1031,383 @@ class DiffusionGrid {
   }
 
  private:
+  /// Adds `amount` to the concentration of box `idx` and applies the
+  /// concentration threshold. Not thread safe.
+  void AddConcentration(size_t idx, double amount) {
+    c1_[idx] += amount;
+    if (c1_[idx] > concentration_threshold_) {
+      c1_[idx] = concentration_threshold_;
+    }
+    if (!c1_zero_bricks_.empty()) {
+      c1_zero_bricks_[GetBrickIndex(idx)] = 0;
+    }
+  }
+
+  /// Resets the brick information (see `SetSparse`). Afterwards, all bricks
+  /// are considered to be non-zero until they are updated the next time.
+  void InitializeBricks() {
+    if (!sparse_) {
+      c1_zero_bricks_.clear();
+      c2_zero_bricks_.clear();
+      return;
+    }
+    for (int i = 0; i < 3; i++) {
+      num_bricks_axis_[i] =
+          (num_boxes_axis_[i] + kBrickLength - 1) / kBrickLength;
+    }
+    c1_zero_bricks_.assign(GetNumBricks(), 0);
+    c2_zero_bricks_.assign(GetNumBricks(), 0);
+  }
+
+  /// Updates the brick information after `steps` diffusion steps of a
+  /// kernel that updated the whole grid. In one step, a brick only receives
+  /// substance from its face neighbors, and the rows at the closed edges are
+  /// not written. Hence, a brick stays zero if it was zero in both buffers
+  /// and its neighbors were zero. Unlike `InitializeBricks`, this keeps the
+  /// information when the sparse and the dense kernels are mixed.
+  void PropagateBricks(uint64_t steps) {
+    if (c1_zero_bricks_.empty()) {
+      return;
+    }
+    const size_t nbx = num_bricks_axis_[0];
+    const size_t nby = num_bricks_axis_[1];
+    const size_t nbz = num_bricks_axis_[2];
+    for (uint64_t i = 0; i < steps; i++) {
+      const uint8_t* src_zero = c1_zero_bricks_.data();
+      uint8_t* dst_zero = c2_zero_bricks_.data();
+#pragma omp parallel for collapse(2)
+      for (size_t bz = 0; bz < nbz; bz++) {
+        for (size_t by = 0; by < nby; by++) {
+          for (size_t bx = 0; bx < nbx; bx++) {
+            size_t brick = bz * nbx * nby + by * nbx + bx;
+            dst_zero[brick] =
+                dst_zero[brick] && IsZeroNeighborhood(src_zero, bx, by, bz);
+          }
+        }
+      }
+      c1_zero_bricks_.swap(c2_zero_bricks_);
+    }
+  }
+
+  size_t GetNumBricks() const {
+    return num_bricks_axis_[0] * num_bricks_axis_[1] * num_bricks_axis_[2];
+  }
+
+  /// Returns the index of the brick that contains box `idx`
+  size_t GetBrickIndex(size_t idx) const {
+    const size_t nx = num_boxes_axis_[0];
+    const size_t ny = num_boxes_axis_[1];
+    size_t x = idx % nx;
+    size_t y = (idx / nx) % ny;
+    size_t z = idx / (nx * ny);
+    return (z / kBrickLength) * num_bricks_axis_[0] * num_bricks_axis_[1] +
+           (y / kBrickLength) * num_bricks_axis_[0] + x / kBrickLength;
+  }
+
+  /// Returns true if brick (bx, by, bz) and its face neighbors are zero.
+  /// The stencil of the diffusion kernels does not reach further.
+  bool IsZeroNeighborhood(const uint8_t* zero_bricks, size_t bx, size_t by,
+                          size_t bz) const {
+    const size_t nbx = num_bricks_axis_[0];
+    const size_t nby = num_bricks_axis_[1];
+    const size_t nbz = num_bricks_axis_[2];
+    size_t brick = bz * nbx * nby + by * nbx + bx;
+    return zero_bricks[brick] && (bx == 0 || zero_bricks[brick - 1]) &&
+           (bx == nbx - 1 || zero_bricks[brick + 1]) &&
+           (by == 0 || zero_bricks[brick - nbx]) &&
+           (by == nby - 1 || zero_bricks[brick + nbx]) &&
+           (bz == 0 || zero_bricks[brick - nbx * nby]) &&
+           (bz == nbz - 1 || zero_bricks[brick + nbx * nby]);
+  }
+
+  /// Sets the concentrations of brick (bx, by, bz) to zero if all of them
+  /// are below or equal to `sparse_threshold_`.
+  /// Returns true if the brick is zero.
+  bool TruncateBrick(double* conc, size_t bx, size_t by, size_t bz) const {
+    const size_t nx = num_boxes_axis_[0];
+    const size_t ny = num_boxes_axis_[1];
+    const size_t nz = num_boxes_axis_[2];
+    const size_t bl = kBrickLength;
+    size_t x_end = std::min(bx * bl + bl, nx);
+    size_t y_end = std::min(by * bl + bl, ny);
+    size_t z_end = std::min(bz * bl + bl, nz);
+    for (size_t z = bz * bl; z < z_end; z++) {
+      for (size_t y = by * bl; y < y_end; y++) {
+        for (size_t x = bx * bl; x < x_end; x++) {
+          if (std::abs(conc[x + y * nx + z * nx * ny]) > sparse_threshold_) {
+            return false;
+          }
+        }
+      }
+    }
+    if (sparse_threshold_ > 0) {
+      for (size_t z = bz * bl; z < z_end; z++) {
+        for (size_t y = by * bl; y < y_end; y++) {
+          std::fill(conc + bx * bl + y * nx + z * nx * ny,
+                    conc + x_end + y * nx + z * nx * ny, 0.0);
+        }
+      }
+    }
+    return true;
+  }
+
+  /// The coefficients of the tridiagonal system
+  /// `-r * c[i-1] + (1 + 2r) * c[i] - r * c[i+1] = d[i]` after the forward
+  /// elimination of the Thomas algorithm (see `DiffuseADI`)
+  struct ThomasCoeff {
+    /// 1 / pivot of each row
+    std::vector<double> inv_pivot_;
+    /// r / pivot of each row (negative modified upper diagonal)
+    std::vector<double> upper_;
+  };
+
+  /// Calculates the coefficients for lines with `n` boxes. With closed edges,
+  /// the box outside of the grid has the same concentration as the edge box
+  /// (zero flux). With leaking edges, its concentration is zero.
+  static ThomasCoeff ThomasCoefficients(size_t n, double r,
+                                        bool leaking_edges) {
+    ThomasCoeff coeff;
+    coeff.inv_pivot_.resize(n);
+    coeff.upper_.resize(n);
+    double pivot_upper = 0;
+    for (size_t i = 0; i < n; i++) {
+      double diagonal = 1 + 2 * r;
+      if (!leaking_edges && i == 0) {
+        diagonal -= r;
+      }
+      if (!leaking_edges && i == n - 1) {
+        diagonal -= r;
+      }
+      double pivot = diagonal - r * pivot_upper;
+      coeff.inv_pivot_[i] = 1 / pivot;
+      coeff.upper_[i] = r / pivot;
+      pivot_upper = coeff.upper_[i];
+    }
+    return coeff;
+  }
+
+  /// Solves the tridiagonal systems of `width` neighboring lines in place.
+  /// Element `i` of line `j` is stored at `c[i * stride + j]`.
+  /// The right-hand side is multiplied by `scale` before the system is
+  /// solved.
+  static void SolveTridiagonal(double* c, size_t n, size_t stride,
+                               size_t width, double r, double scale,
+                               const ThomasCoeff& coeff) {
+    const double* inv_pivot = coeff.inv_pivot_.data();
+    const double* upper = coeff.upper_.data();
+    // forward elimination
+#pragma omp simd
+    for (size_t j = 0; j < width; j++) {
+      c[j] = scale * c[j] * inv_pivot[0];
+    }
+    for (size_t i = 1; i < n; i++) {
+      double* current = c + i * stride;
+      const double* previous = current - stride;
+#pragma omp simd
+      for (size_t j = 0; j < width; j++) {
+        current[j] = (scale * current[j] + r * previous[j]) * inv_pivot[i];
+      }
+    }
+    // back substitution
+    for (size_t i = n - 1; i-- > 0;) {
+      double* current = c + i * stride;
+      const double* next = current + stride;
+#pragma omp simd
+      for (size_t j = 0; j < width; j++) {
+        current[j] += upper[i] * next[j];
+      }
+    }
+  }
+
+  /// Calculates row (y, z) of the next time step `dst` from the
+  /// concentrations `src` (see `DiffuseEuler`)
+  void DiffuseEulerRow(const double* src, double* dst, size_t y, size_t z) {
+    DiffuseEulerRow(src, dst, y, z, 0, num_boxes_axis_[0]);
+  }
+
+  /// Calculates the boxes [x_begin, x_end) of row (y, z)
+  void DiffuseEulerRow(const double* src, double* dst, size_t y, size_t z,
+                       size_t x_begin, size_t x_end) {
+    const auto nx = num_boxes_axis_[0];
+    const auto ny = num_boxes_axis_[1];
+    const auto nz = num_boxes_axis_[2];
+    if (y == 0 || y == (ny - 1) || z == 0 || z == (nz - 1)) {
+      return;
+    }
+
+    const double ibl2 = 1 / (box_length_ * box_length_);
+    const double d = 1 - dc_[0];
+    const double dt = substep_dt_;
+
+    size_t x_start = std::max<size_t>(x_begin, 1);
+    size_t x_stop = std::min<size_t>(x_end, nx - 1);
+    size_t x;
+    int c, n, s, b, t;
+    c = x_start - 1 + y * nx + z * nx * ny;
+#pragma omp simd
+    for (x = x_start; x < x_stop; x++) {
+      ++c;
+      n = c - nx;
+      s = c + nx;
+      b = c - nx * ny;
+      t = c + nx * ny;
+      dst[c] = (src[c] +
+                d * dt * (src[c - 1] - 2 * src[c] + src[c + 1]) * ibl2 +
+                d * dt * (src[s] - 2 * src[c] + src[n]) * ibl2 +
+                d * dt * (src[b] - 2 * src[c] + src[t]) * ibl2) *
+               (1 - mu_);
+    }
+  }
+
+  /// Calculates row (y, z) of the next time step `dst` from the
+  /// concentrations `src` (see `DiffuseEulerLeakingEdge`)
+  void DiffuseEulerLeakingEdgeRow(const double* src, double* dst, size_t y,
+                                  size_t z) {
+    DiffuseEulerLeakingEdgeRow(src, dst, y, z, 0, num_boxes_axis_[0]);
+  }
+
+  /// Calculates the boxes [x_begin, x_end) of row (y, z)
+  void DiffuseEulerLeakingEdgeRow(const double* src, double* dst, size_t y,
+                                  size_t z, size_t x_begin, size_t x_end) {
+    const auto nx = num_boxes_axis_[0];
+    const auto ny = num_boxes_axis_[1];
+    const auto nz = num_boxes_axis_[2];
+
+    const double ibl2 = 1 / (box_length_ * box_length_);
+    const double d = 1 - dc_[0];
+    const double dt = substep_dt_;
+    std::array<int, 4> l;
+
+    // offsets of the neighbors in y and z direction
+    int on, os, ob, ot;
+
+    l.fill(1);
+
+    if (y == 0) {
+      on = 0;
+      l[0] = 0;
+    } else {
+      on = -nx;
+    }
+
+    if (y == ny - 1) {
+      os = 0;
+      l[1] = 0;
+    } else {
+      os = nx;
+    }
+
+    if (z == 0) {
+      ob = 0;
+      l[2] = 0;
+    } else {
+      ob = -nx * ny;
+    }
+
+    if (z == nz - 1) {
+      ot = 0;
+      l[3] = 0;
+    } else {
+      ot = nx * ny;
+    }
+
+    size_t x_start = std::max<size_t>(x_begin, 1);
+    size_t x_stop = std::min<size_t>(x_end, nx - 1);
+    size_t x;
+    int c, n, s, b, t;
+    c = x_start - 1 + y * nx + z * nx * ny;
+    n = c + on;
+    s = c + os;
+    b = c + ob;
+    t = c + ot;
+
+    if (x_begin == 0) {
+      // x = 0; we leak out substances past this edge (so multiply by 0)
+      dst[c] = (src[c] + d * dt * (0 - 2 * src[c] + src[c + 1]) * ibl2 +
+                d * dt * (src[s] - 2 * src[c] + src[n]) * ibl2 +
+                d * dt * (src[b] - 2 * src[c] + src[t]) * ibl2) *
+               (1 - mu_);
+    }
+#pragma omp simd
+    for (x = x_start; x < x_stop; x++) {
+      ++c;
+      ++n;
+      ++s;
+      ++b;
+      ++t;
+      dst[c] =
+          (src[c] + d * dt * (src[c - 1] - 2 * src[c] + src[c + 1]) * ibl2 +
+           d * dt * (l[0] * src[s] - 2 * src[c] + l[1] * src[n]) * ibl2 +
+           d * dt * (l[2] * src[b] - 2 * src[c] + l[3] * src[t]) * ibl2) *
+          (1 - mu_);
+    }
+    if (x_end == nx) {
+      // x = nx-1; we leak out substances past this edge (so multiply by 0)
+      c = nx - 1 + y * nx + z * nx * ny;
+      n = c + on;
+      s = c + os;
+      b = c + ob;
+      t = c + ot;
+      dst[c] = (src[c] + d * dt * (src[c - 1] - 2 * src[c] + 0) * ibl2 +
+                d * dt * (src[s] - 2 * src[c] + src[n]) * ibl2 +
+                d * dt * (src[b] - 2 * src[c] + src[t]) * ibl2) *
+               (1 - mu_);
+    }
+  }
+
+  /// Calculates the gradients of row (y, z) from the concentrations
+  /// `conc` (see `CalculateGradient`)
+  void CalculateGradientRow(const double* conc, size_t y, size_t z) {
+    double gd = 1 / (box_length_ * 2);
+
+    auto nx = num_boxes_axis_[0];
+    auto ny = num_boxes_axis_[1];
+    auto nz = num_boxes_axis_[2];
+
+    for (size_t x = 0; x < nx; x++) {
+      int c, e, w, n, s, b, t;
+      c = x + y * nx + z * nx * ny;
+
+      if (x == 0) {
+        e = c;
+        w = c + 2;
+      } else if (x == nx - 1) {
+        e = c - 2;
+        w = c;
+      } else {
+        e = c - 1;
+        w = c + 1;
+      }
+
+      if (y == 0) {
+        n = c + 2 * nx;
+        s = c;
+      } else if (y == ny - 1) {
+        n = c;
+        s = c - 2 * nx;
+      } else {
+        n = c + nx;
+        s = c - nx;
+      }
+
+      if (z == 0) {
+        t = c + 2 * nx * ny;
+        b = c;
+      } else if (z == nz - 1) {
+        t = c;
+        b = c - 2 * nx * ny;
+      } else {
+        t = c + nx * ny;
+        b = c - nx * ny;
+      }
+
+      // Let the gradient point from low to high concentration
+      gradients_[3 * c + 0] = (conc[w] - conc[e]) * gd;
+      gradients_[3 * c + 1] = (conc[n] - conc[s]) * gd;
+      gradients_[3 * c + 2] = (conc[t] - conc[b]) * gd;
+    }
+  }
+
   /// The id of the substance of this grid
   int substance_ = 0;
   /// The name of the substance of this grid
@@ -763,6 +1429,10 @@ class DiffusionGrid {
   /// The timestep resolution fhe diffusion grid
   // TODO(ahmad): this probably needs to scale with Param::simulation_timestep
   double dt_ = 1;
+  /// The number of diffusion steps per simulation step
+  uint64_t num_substeps_ = 1;
+  /// The time step of one diffusion step (`dt_ / num_substeps_`)
+  double substep_dt_ = 1;
   /// The decay constant
   double mu_ = 0;
   /// The grid dimensions of the diffusion grid
@@ -773,6 +1443,8 @@ class DiffusionGrid {
   size_t total_num_boxes_ = 0;
   /// Flag to determine if this grid has been initialized
   bool initialized_ = false;
+  /// The numerical method used in `DiffusionOp`
+  DiffusionMethod diffusion_method_ = kEuler;
   /// The resolution of the diffusion grid
   int resolution_ = 0;
   /// If false, grid dimensions are even; if true, they are odd
@@ -782,7 +1454,30 @@ class DiffusionGrid {
   // turn to true after gradient initialization
   bool init_gradient_ = false;
 
-  BDM_CLASS_DEF_NV(DiffusionGrid, 1);
+  /// Secretion of one thread that has not been added to `c1_` yet
+  /// (box index, amount). Padded to avoid false sharing; assumes 64 byte
+  /// cache lines.
+  struct SecretionBuffer {
+    std::vector<std::pair<size_t, double>> data_;
+    char padding_[64 - sizeof(std::vector<std::pair<size_t, double>>)];
+  };
+  /// One secretion buffer per thread (see `IncreaseConcentrationBy`)
+  std::vector<SecretionBuffer> secretion_buffers_;  //!
+
+  /// Number of boxes along each axis of a brick (see `SetSparse`)
+  static constexpr size_t kBrickLength = 8;
+  /// Only update bricks with non-negligible concentration
+  bool sparse_ = false;  //!
+  /// Concentration below which a brick is set to zero
+  double sparse_threshold_ = 0;  //!
+  /// The number of bricks along each axis
+  std::array<size_t, 3> num_bricks_axis_ = {{0}};  //!
+  /// For each brick, if all concentrations in `c1_` are known to be zero
+  std::vector<uint8_t> c1_zero_bricks_;  //!
+  /// For each brick, if all concentrations in `c2_` are known to be zero
+  std::vector<uint8_t> c2_zero_bricks_;  //!
+
+  BDM_CLASS_DEF_NV(DiffusionGrid, 3);
 };
 
 }  // namespace bdm
@@ -15,6 +15,7 @@
 #include "core/execution_context/in_place_exec_ctxt.h"
 
 #include "core/grid.h"
+#include "core/param/param.h"
 #include "core/resource_manager.h"
 #include "core/sim_object/sim_object.h"
 
@@ -65,24 +66,39 @@ void InPlaceExecutionContext::TearDownIterationAll(
     ctxt->new_sim_objects_.clear();
   }
 
-  // remove
+  // add the secretion of this iteration, also if `DiffusionOp` is not
+  // executed in this iteration
+  rm->ApplyOnAllDiffusionGrids(
+      [](DiffusionGrid* dgrid) { dgrid->CommitSecretion(); });
+
+  // removed sim objects
+  // remove them after adding new ones (maybe one has been removed
+  // that was in new_sim_objects_)
+  uint64_t num_removed = 0;
+  for (int i = 0; i < tinfo_->GetMaxThreads(); i++) {
+    num_removed += all_exec_ctxts[i]->remove_.size();
+  }
+  if (num_removed == 0) {
+    return;
+  }
+  std::vector<SoUid> remove;
+  remove.reserve(num_removed);
   for (int i = 0; i < tinfo_->GetMaxThreads(); i++) {
     auto* ctxt = all_exec_ctxts[i];
-    // removed sim objects
-    // remove them after adding new ones (maybe one has been removed
-    // that was in new_sim_objects_)
-    for (auto& uid : ctxt->remove_) {
-      rm->Remove(uid);
-    }
+    remove.insert(remove.end(), ctxt->remove_.begin(), ctxt->remove_.end());
     ctxt->remove_.clear();
   }
+  rm->RemoveSimObjects(remove);
 }
 
 void InPlaceExecutionContext::Execute(
     SimObject* so, const std::vector<Operation>& operations) {
-  auto* grid = Simulation::GetActive()->GetGrid();
+  auto* sim = Simulation::GetActive();
+  auto* grid = sim->GetGrid();
   auto nb_mutex_builder = grid->GetNeighborMutexBuilder();
-  if (nb_mutex_builder != nullptr) {
+  // With box coloring the scheduler never executes neighboring simulation
+  // objects at the same time. Hence, no mutex is needed.
+  if (nb_mutex_builder != nullptr && !sim->GetParam()->box_coloring_) {
     auto mutex = nb_mutex_builder->GetMutex(so->GetBoxIdx());
     std::lock_guard<decltype(mutex)> guard(mutex);
     neighbor_cache_.clear();
@@ -104,66 +120,28 @@ void InPlaceExecutionContext::push_back(SimObject* new_so) {  // NOLINT
 void InPlaceExecutionContext::ForEachNeighbor(
     const std::function<void(const SimObject*)>& lambda,
     const SimObject& query) {
-  // use values in cache
-  if (neighbor_cache_.size() != 0) {
-    for (auto& pair : neighbor_cache_) {
-      lambda(pair.first);
-    }
-    return;
-  }
-
-  auto* grid = Simulation::GetActive()->GetGrid();
-  grid->ForEachNeighbor(lambda, query);
+  ForEachNeighbor(lambda, query, std::false_type());
 }
 
 void InPlaceExecutionContext::ForEachNeighbor(
     const std::function<void(const SimObject*, double)>& lambda,
     const SimObject& query) {
-  // use values in cache
-  if (neighbor_cache_.size() != 0) {
-    for (auto& pair : neighbor_cache_) {
-      lambda(pair.first, pair.second);
-    }
-    return;
-  }
-
-  // forward call to grid and populate cache
-  auto* grid = Simulation::GetActive()->GetGrid();
-  auto* param = Simulation::GetActive()->GetParam();
-  auto for_each = [&, this](const SimObject* so, double squared_distance) {
-    if (param->cache_neighbors_) {
-      this->neighbor_cache_.push_back(make_pair(so, squared_distance));
-    }
-    lambda(so, squared_distance);
-  };
-  grid->ForEachNeighbor(for_each, query);
+  ForEachNeighbor(lambda, query, std::true_type());
 }
 
 void InPlaceExecutionContext::ForEachNeighborWithinRadius(
     const std::function<void(const SimObject*)>& lambda, const SimObject& query,
     double squared_radius) {
-  // use values in cache
-  if (neighbor_cache_.size() != 0) {
-    for (auto& pair : neighbor_cache_) {
-      if (pair.second < squared_radius) {
-        lambda(pair.first);
-      }
-    }
-    return;
-  }
+  ForEachNeighborWithinRadius<std::function<void(const SimObject*)>>(
+      lambda, query, squared_radius);
+}
 
-  // forward call to grid and populate cache
-  auto* grid = Simulation::GetActive()->GetGrid();
-  auto* param = Simulation::GetActive()->GetParam();
-  auto for_each = [&, this](const SimObject* so, double squared_distance) {
-    if (param->cache_neighbors_) {
-      this->neighbor_cache_.push_back(make_pair(so, squared_distance));
-    }
-    if (squared_distance < squared_radius) {
-      lambda(so);
-    }
-  };
-  grid->ForEachNeighbor(for_each, query);
+Grid* InPlaceExecutionContext::GetGrid() const {
+  return Simulation::GetActive()->GetGrid();
+}
+
+bool InPlaceExecutionContext::CacheNeighbors() const {
+  return Simulation::GetActive()->GetParam()->cache_neighbors_;
 }
 
 SimObject* InPlaceExecutionContext::GetSimObject(SoUid uid) {
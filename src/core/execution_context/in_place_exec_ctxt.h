@@ -17,15 +17,18 @@
 
 #include <tbb/concurrent_unordered_map.h>
 #include <functional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "core/operation/operation.h"
 #include "core/sim_object/so_uid.h"
 #include "core/util/thread_info.h"
+#include "core/util/type.h"
 
 namespace bdm {
 
+class Grid;
 class SimObject;
 
 /// This execution context updates simulation objects in place. \n
@@ -41,6 +44,9 @@ class SimObject;
 /// been added. If neighbors are not modified, this protection can be turned off
 ///  to improve performance using `DisableNeighborGuard()`. By default it is
 /// turned on.\n
+/// Alternatively, `Param::box_coloring_` replaces the per object mutex with
+/// a schedule that never processes neighboring simulation objects at the same
+/// time.\n
 /// New sim objects will only be visible at the next iteration. \n
 /// Also removal of a sim object happens at the end of each iteration.
 class InPlaceExecutionContext {
@@ -69,6 +75,15 @@ class InPlaceExecutionContext {
 
   void push_back(SimObject* new_so);  // NOLINT
 
+  /// Calls `lambda` for each neighbor of `query`. `lambda` is called with
+  /// `(const SimObject* neighbor)` or with
+  /// `(const SimObject* neighbor, double squared_distance)`.\n
+  /// Since `lambda` is a template parameter, calls can be inlined.
+  template <typename TLambda>
+  void ForEachNeighbor(const TLambda& lambda, const SimObject& query) {
+    ForEachNeighbor(lambda, query, is_neighbor_distance_functor<TLambda>());
+  }
+
   void ForEachNeighbor(const std::function<void(const SimObject*)>& lambda,
                        const SimObject& query);
 
@@ -76,7 +91,37 @@ class InPlaceExecutionContext {
       const std::function<void(const SimObject*, double)>& lambda,
       const SimObject& query);
 
-  /// Forwards the call to `Grid::ForEachNeighborWithinRadius`
+  /// Calls `lambda(const SimObject* neighbor)` for each neighbor of `query`
+  /// whose squared distance is smaller than `squared_radius`.\n
+  /// Unless the neighbors are cached (see `Param::cache_neighbors_`), the
+  /// query is forwarded to `Grid::ForEachNeighborWithinRadius`, which skips
+  /// boxes outside the search sphere.\n
+  /// Since `lambda` is a template parameter, calls can be inlined.
+  template <typename TLambda, typename TGrid = Grid>
+  void ForEachNeighborWithinRadius(const TLambda& lambda,
+                                   const SimObject& query,
+                                   double squared_radius) {
+    auto for_each = [&](const SimObject* neighbor, double squared_distance) {
+      if (squared_distance < squared_radius) {
+        lambda(neighbor);
+      }
+    };
+    // use values in cache
+    if (neighbor_cache_.size() != 0) {
+      for (auto& pair : neighbor_cache_) {
+        for_each(pair.first, pair.second);
+      }
+      return;
+    }
+    if (CacheNeighbors()) {
+      // the cache must contain all neighbors, not only those within radius
+      ForEachNeighborFromGrid<TGrid>(for_each, query);
+      return;
+    }
+    static_cast<TGrid*>(GetGrid())
+        ->ForEachNeighborWithinRadius(lambda, query, squared_radius);
+  }
+
   void ForEachNeighborWithinRadius(
       const std::function<void(const SimObject*)>& lambda,
       const SimObject& query, double squared_radius);
@@ -109,6 +154,67 @@ class InPlaceExecutionContext {
   std::vector<std::pair<const SimObject*, double>> neighbor_cache_;
 
   SimObject* GetCachedSimObject(SoUid uid);
+
+  /// Returns the grid of the active simulation.
+  /// grid.h cannot be included in this header (include cycle through
+  /// so_pointer.h). Therefore, the templates below access the grid through
+  /// the dependent type `TGrid`, which is only instantiated where `Grid` is
+  /// complete.
+  Grid* GetGrid() const;
+
+  /// Returns `Param::cache_neighbors_` of the active simulation
+  bool CacheNeighbors() const;
+
+  template <typename TLambda, typename TGrid = Grid>
+  void ForEachNeighbor(const TLambda& lambda, const SimObject& query,
+                       std::false_type) {
+    // use values in cache
+    if (neighbor_cache_.size() != 0) {
+      for (auto& pair : neighbor_cache_) {
+        lambda(pair.first);
+      }
+      return;
+    }
+    if (CacheNeighbors()) {
+      ForEachNeighborFromGrid<TGrid>(
+          [&](const SimObject* neighbor, double) { lambda(neighbor); }, query);
+      return;
+    }
+    // neighbor-only search: the grid does not calculate distances
+    static_cast<TGrid*>(GetGrid())->ForEachNeighbor(lambda, query);
+  }
+
+  template <typename TLambda, typename TGrid = Grid>
+  void ForEachNeighbor(const TLambda& lambda, const SimObject& query,
+                       std::true_type) {
+    // use values in cache
+    if (neighbor_cache_.size() != 0) {
+      for (auto& pair : neighbor_cache_) {
+        lambda(pair.first, pair.second);
+      }
+      return;
+    }
+    ForEachNeighborFromGrid<TGrid>(lambda, query);
+  }
+
+  /// Forwards `lambda(neighbor, squared_distance)` to the grid. Populates
+  /// `neighbor_cache_` on the way if `Param::cache_neighbors_` is turned on,
+  /// so that subsequent searches for the same simulation object can reuse
+  /// the result.
+  template <typename TGrid, typename TLambda>
+  void ForEachNeighborFromGrid(const TLambda& lambda, const SimObject& query) {
+    auto* grid = static_cast<TGrid*>(GetGrid());
+    if (!CacheNeighbors()) {
+      grid->ForEachNeighbor(lambda, query);
+      return;
+    }
+    grid->ForEachNeighbor(
+        [&](const SimObject* neighbor, double squared_distance) {
+          neighbor_cache_.emplace_back(neighbor, squared_distance);
+          lambda(neighbor, squared_distance);
+        },
+        query);
+  }
 };
 
 }  // namespace bdm
@@ -22,13 +22,12 @@
 #include <array>
 #include <atomic>
 #include <cmath>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <mutex>
-#ifdef LINUX
-#include <parallel/algorithm>
-#endif  // LINUX
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -42,6 +41,10 @@
 #include "core/param/param.h"
 #include "core/resource_manager.h"
 #include "core/util/log.h"
+#include "core/util/math.h"
+#include "core/util/radix_sort.h"
+#include "core/util/type.h"
+#include "core/verlet_list.h"
 
 namespace bdm {
 
@@ -128,7 +131,7 @@ class Grid {
 
     /// An iterator that iterates over the cells in this box
     struct Iterator {
-      Iterator(Grid* grid, const Box* box)
+      Iterator(const Grid* grid, const Box* box)
           : grid_(grid),
             current_value_(box->start_),
             countdown_(box->length_) {}
@@ -146,7 +149,7 @@ class Grid {
       SoHandle operator*() const { return current_value_; }
 
       /// Pointer to the neighbor grid; for accessing the successor_ list
-      Grid* grid_;
+      const Grid* grid_;
       /// The current simulation object to be considered
       SoHandle current_value_;
       /// The remain number of simulation objects to consider
@@ -158,15 +161,16 @@ class Grid {
     }
   };
 
-  /// An iterator that iterates over the boxes in this grid
+  /// An iterator that iterates over the simulation objects in the neighbor
+  /// boxes of a query box (see `Grid::neighbor_box_offsets_`)
   struct NeighborIterator {
-    explicit NeighborIterator(
-        const FixedSizeVector<const Box*, 27>& neighbor_boxes)
-        : neighbor_boxes_(neighbor_boxes),
+    NeighborIterator(const Grid* grid, size_t box_idx)
+        : grid_(grid),
+          center_idx_(box_idx),
           // start iterator from box 0
-          box_iterator_(neighbor_boxes_[0]->begin()) {
+          box_iterator_(grid, GetNeighborBox(0)) {
       // if first box is empty
-      if (neighbor_boxes_[0]->IsEmpty()) {
+      if (GetNeighborBox(0)->IsEmpty()) {
         ForwardToNonEmptyBox();
       }
     }
@@ -186,27 +190,36 @@ class Grid {
     }
 
    private:
-    /// The 27 neighbor boxes that will be searched for simulation objects
-    const FixedSizeVector<const Box*, 27>& neighbor_boxes_;
+    /// Grid that contains the neighbor boxes
+    const Grid* grid_;
+    /// Index of the query box
+    size_t center_idx_;
     /// The box that shall be considered to iterate over for finding simulation
     /// objects
     typename Box::Iterator box_iterator_;
-    /// The id of the box to be considered (i.e. value between 0 - 26)
-    uint16_t box_idx_ = 0;
+    /// The id of the neighbor box to be considered (i.e. index into
+    /// `Grid::neighbor_box_offsets_`)
+    uint32_t box_idx_ = 0;
     /// Flag to indicate that all the neighbor boxes have been searched through
     bool is_end_ = false;
 
+    const Box* GetNeighborBox(uint32_t i) const {
+      return grid_->GetBoxPointer(center_idx_ +
+                                  grid_->neighbor_box_offsets_[i]);
+    }
+
     /// Forwards the iterator to the next non empty box and returns itself
     /// If there are no non empty boxes is_end_ is set to true
     NeighborIterator& ForwardToNonEmptyBox() {
       // increment box id until non empty box has been found
-      while (++box_idx_ < neighbor_boxes_.size()) {
+      while (++box_idx_ < grid_->neighbor_box_offsets_.size()) {
         // box is empty or uninitialized (padding box) -> continue
-        if (neighbor_boxes_[box_idx_]->IsEmpty()) {
+        auto* box = GetNeighborBox(box_idx_);
+        if (box->IsEmpty()) {
           continue;
         }
         // a non-empty box has been found
-        box_iterator_ = neighbor_boxes_[box_idx_]->begin();
+        box_iterator_ = typename Box::Iterator(grid_, box);
         return *this;
       }
       // all remaining boxes have been empty; reached end
@@ -215,11 +228,12 @@ class Grid {
     }
   };
 
-  /// Enum that determines the degree of adjacency in search neighbor boxes
-  //  todo(ahmad): currently only kHigh is supported (hardcoded 26 several
-  //  places)
+  /// Enum that determines the degree of adjacency in search neighbor boxes.
+  /// If the neighborhood spans more than one layer of boxes (see
+  /// `Param::grid_search_radius_`), the offset of a neighbor box may be
+  /// non-zero along at most one (kLow), two (kMedium), or three (kHigh) axes.
   enum Adjacency {
-    kLow,    /**< The closest 8  neighboring boxes */
+    kLow,    /**< The closest 6  neighboring boxes */
     kMedium, /**< The closest 18  neighboring boxes */
     kHigh    /**< The closest 26  neighboring boxes */
   };
@@ -240,6 +254,35 @@ class Grid {
 
   virtual ~Grid() {}
 
+  /// Counters of `ForEachNeighborWithinRadius`. Only collected if
+  /// `Param::statistics_` is set.
+  struct NeighborSearchStatistics {
+    /// Number of simulation objects for which the distance was calculated
+    uint64_t visited_ = 0;
+    /// Number of simulation objects that were within the search radius
+    uint64_t accepted_ = 0;
+    /// Number of neighbor boxes that were skipped, because they do not
+    /// intersect the search sphere
+    uint64_t skipped_boxes_ = 0;
+  };
+
+  /// Returns the accumulated neighbor search statistics of all threads
+  NeighborSearchStatistics GetNeighborSearchStatistics() const {
+    NeighborSearchStatistics result;
+    for (auto& stats : neighbor_statistics_) {
+      result.visited_ += stats[0];
+      result.accepted_ += stats[1];
+      result.skipped_boxes_ += stats[2];
+    }
+    return result;
+  }
+
+  void ResetNeighborSearchStatistics() {
+    for (auto& stats : neighbor_statistics_) {
+      stats = {{0}};
+    }
+  }
+
   /// Clears the grid
   void ClearGrid() {
     boxes_.clear();
@@ -252,13 +295,56 @@ class Grid {
     threshold_dimensions_ = {inf, -inf};
     successors_.clear();
     has_grown_ = false;
+    incremental_update_ready_ = false;
   }
 
   /// Updates the grid, as simulation objects may have moved, added or deleted
+  /// If `Param::incremental_grid_update_` is set, only simulation objects that
+  /// changed their box are relinked. A full rebuild is only performed if the
+  /// grid has to grow.
   void UpdateGrid() {
     auto* rm = Simulation::GetActive()->GetResourceManager();
+    auto* param = Simulation::GetActive()->GetParam();
+
+    if (collect_statistics_ != param->statistics_) {
+      collect_statistics_ = param->statistics_;
+      neighbor_statistics_.resize(omp_get_max_threads(), {{0}});
+    }
 
     if (rm->GetNumSimObjects() != 0) {
+      sorted_cell_list_ = param->sorted_cell_list_;
+      bool periodic = param->bound_space_ && param->periodic_boundary_;
+      if (periodic != periodic_) {
+        incremental_update_ready_ = false;
+        verlet_list_.Invalidate();
+      }
+      periodic_ = periodic;
+      periodic_length_ = param->max_bound_ - param->min_bound_;
+
+      const double skin = param->verlet_skin_;
+      if (skin > 0 && skin == verlet_list_.GetSkin() &&
+          verlet_list_.IsValid()) {
+        // All interactions are still covered by the Verlet list; neither the
+        // boxes nor the list have to be updated.
+        has_grown_ = false;
+        return;
+      }
+      verlet_list_.Invalidate();
+
+      if (param->incremental_grid_update_ && incremental_update_ready_ &&
+          UpdateGridIncrementally()) {
+        if (periodic_) {
+          UpdateGhostBoxes();
+        }
+        if (sorted_cell_list_) {
+          UpdateSortedCellList();
+        }
+        if (skin > 0) {
+          BuildVerletList(skin);
+        }
+        return;
+      }
+
       ClearGrid();
 
       auto inf = Math::kInfinity;
@@ -270,28 +356,51 @@ class Grid {
       assert(los > 0 &&
              "The largest object size was found to be 0. Please check if your "
              "cells are correctly initialized.");
-      box_length_ = los;
-
-      for (int i = 0; i < 3; i++) {
-        int dimension_length =
-            grid_dimensions_[2 * i + 1] - grid_dimensions_[2 * i];
-        int r = dimension_length % box_length_;
-        // If the grid is not perfectly divisible along each dimension by the
-        // resolution, extend the grid so that it is
-        if (r != 0) {
-          // std::abs for the case that box_length_ > dimension_length
-          grid_dimensions_[2 * i + 1] += (box_length_ - r);
-        } else {
-          // Else extend the grid dimension with one row, because the outmost
-          // object lies exactly on the border
-          grid_dimensions_[2 * i + 1] += box_length_;
+      box_length_ =
+          param->grid_box_length_ != 0 ? param->grid_box_length_ : los;
+      num_rings_ = CalculateNumRings(largest_object_size_);
+
+      if (periodic_) {
+        // The grid covers the bound space. If its length is not a multiple
+        // of the box length, the last box along each axis is larger (see
+        // `GetBoxIndex`).
+        int32_t min = param->min_bound_;
+        int32_t max = param->max_bound_;
+        int32_t num_boxes = (max - min) / static_cast<int32_t>(box_length_);
+        if (num_boxes < 2 * static_cast<int32_t>(num_rings_) + 1) {
+          Log::Fatal("Grid",
+                     "Periodic boundaries require at least 2 * num_rings + 1 "
+                     "boxes along each axis. Please increase the simulation "
+                     "space (Param::min_bound_, Param::max_bound_) or "
+                     "decrease the box length.");
+        }
+        int32_t upper = min + num_boxes * static_cast<int32_t>(box_length_);
+        grid_dimensions_ = {min, upper, min, upper, min, upper};
+      } else {
+        for (int i = 0; i < 3; i++) {
+          int dimension_length =
+              grid_dimensions_[2 * i + 1] - grid_dimensions_[2 * i];
+          int r = dimension_length % box_length_;
+          // If the grid is not perfectly divisible along each dimension by
+          // the resolution, extend the grid so that it is
+          if (r != 0) {
+            // std::abs for the case that box_length_ > dimension_length
+            grid_dimensions_[2 * i + 1] += (box_length_ - r);
+          } else {
+            // Else extend the grid dimension with one row, because the
+            // outmost object lies exactly on the border
+            grid_dimensions_[2 * i + 1] += box_length_;
+          }
         }
       }
 
-      // Pad the grid to avoid out of bounds check when search neighbors
+      // Pad the grid to avoid out of bounds check when search neighbors.
+      // With periodic boundaries the padding boxes mirror the boxes at the
+      // opposite face (see `UpdateGhostBoxes`).
+      int32_t padding = box_length_ * num_rings_;
       for (int i = 0; i < 3; i++) {
-        grid_dimensions_[2 * i] -= box_length_;
-        grid_dimensions_[2 * i + 1] += box_length_;
+        grid_dimensions_[2 * i] -= padding;
+        grid_dimensions_[2 * i + 1] += padding;
       }
 
       // Calculate how many boxes fit along each dimension
@@ -305,6 +414,7 @@ class Grid {
 
       num_boxes_xy_ = num_boxes_axis_[0] * num_boxes_axis_[1];
       auto total_num_boxes = num_boxes_xy_ * num_boxes_axis_[2];
+      UpdateNeighborBoxOffsets();
 
       CheckGridGrowth();
 
@@ -312,18 +422,34 @@ class Grid {
         boxes_.resize(total_num_boxes, Box());
       }
 
-      successors_.reserve();
+      bool incremental = param->incremental_grid_update_;
+      if (incremental) {
+        successors_.resize();
+        handle_states_.resize();
+      } else {
+        successors_.reserve();
+      }
 
       // Assign simulation objects to boxes
       rm->ApplyOnAllElementsParallelDynamic(
-          1000, [this](SimObject* sim_object, SoHandle soh) {
+          1000, [&](SimObject* sim_object, SoHandle soh) {
             const auto& position = sim_object->GetPosition();
             auto idx = this->GetBoxIndex(position);
             auto box = this->GetBoxPointer(idx);
             box->AddObject(soh, &successors_);
             sim_object->SetBoxIdx(idx);
+            if (incremental) {
+              handle_states_[soh] = {sim_object->GetUid(),
+                                     static_cast<uint32_t>(idx), false};
+            }
           });
-      auto* param = Simulation::GetActive()->GetParam();
+      incremental_update_ready_ = incremental;
+      if (periodic_) {
+        UpdateGhostBoxes();
+      }
+      if (sorted_cell_list_) {
+        UpdateSortedCellList();
+      }
       if (param->bound_space_) {
         int min = param->min_bound_;
         int max = param->max_bound_;
@@ -333,9 +459,13 @@ class Grid {
       if (nb_mutex_builder_ != nullptr) {
         nb_mutex_builder_->Update();
       }
+      if (skin > 0) {
+        BuildVerletList(skin);
+      }
     } else {
       // There are no sim objects in this simulation
-      auto* param = Simulation::GetActive()->GetParam();
+      incremental_update_ready_ = false;
+      verlet_list_.Invalidate();
 
       bool uninitialized = boxes_.size() == 0;
       if (uninitialized && param->bound_space_) {
@@ -372,96 +502,201 @@ class Grid {
   ///
   /// @return     The distance between the two points
   ///
+  /// With periodic boundaries the distance to the closest periodic image is
+  /// returned (minimum image convention).
   inline double SquaredEuclideanDistance(const Double3& pos1,
                                          const Double3& pos2) const {
-    const double dx = pos2[0] - pos1[0];
-    const double dy = pos2[1] - pos1[1];
-    const double dz = pos2[2] - pos1[2];
+    const double dx = MinimumImage(pos2[0] - pos1[0]);
+    const double dy = MinimumImage(pos2[1] - pos1[1]);
+    const double dz = MinimumImage(pos2[2] - pos1[2]);
     return (dx * dx + dy * dy + dz * dz);
   }
 
   inline bool WithinSquaredEuclideanDistance(double squared_radius,
                                              const Double3& pos1,
                                              const Double3& pos2) const {
-    const double dx = pos2[0] - pos1[0];
+    const double dx = MinimumImage(pos2[0] - pos1[0]);
     const double dx2 = dx * dx;
     if (dx2 > squared_radius) {
       return false;
     }
 
-    const double dy = pos2[1] - pos1[1];
+    const double dy = MinimumImage(pos2[1] - pos1[1]);
     const double dy2_plus_dx2 = dy * dy + dx2;
     if (dy2_plus_dx2 > squared_radius) {
       return false;
     }
 
-    const double dz = pos2[2] - pos1[2];
+    const double dz = MinimumImage(pos2[2] - pos1[2]);
     const double distance = dz * dz + dy2_plus_dx2;
     return distance < squared_radius;
   }
 
+  /// Returns the component of a distance vector that corresponds to the
+  /// closest periodic image. Without periodic boundaries `distance` is
+  /// returned unchanged.
+  inline double MinimumImage(double distance) const {
+    return Math::MinimumImage(distance, GetPeriodicLength());
+  }
+
+  /// Returns the length of the simulation space if periodic boundaries are
+  /// used; zero otherwise
+  double GetPeriodicLength() const { return periodic_ ? periodic_length_ : 0; }
+
+  /// @brief      Sorts all non-empty boxes by the 64 bit morton code of their
+  ///             box coordinates (Z-order).
+  ///
+  /// Empty boxes are skipped. The morton codes are sorted with a parallel
+  /// radix sort that only processes the bits that are required for the
+  /// current number of boxes per axis.
+  /// The result is used by `ZOrderIterator`.
   void UpdateBoxZOrder() {
-    // iterate boxes in Z-order / morton order
-    // TODO(lukas) this is a very quick attempt to test an idea
-    // improve performance of this brute force solution
-    zorder_sorted_boxes_.resize(boxes_.size());
-#pragma omp parallel for collapse(3)
-    for (uint32_t x = 0; x < num_boxes_axis_[0]; x++) {
-      for (uint32_t y = 0; y < num_boxes_axis_[1]; y++) {
-        for (uint32_t z = 0; z < num_boxes_axis_[2]; z++) {
-          auto box_idx = GetBoxIndex(std::array<uint32_t, 3>{x, y, z});
-          auto morton = libmorton::morton3D_64_encode(x, y, z);
-          zorder_sorted_boxes_[box_idx] =
-              std::pair<uint32_t, const Box*>{morton, &boxes_[box_idx]};
+    uint32_t max_boxes_axis = *std::max_element(num_boxes_axis_.begin(),
+                                                num_boxes_axis_.end());
+    uint32_t bits_per_axis = 0;
+    while ((static_cast<uint64_t>(1) << bits_per_axis) < max_boxes_axis) {
+      bits_per_axis++;
+    }
+    // libmorton supports at most 21 bits per axis for 64 bit codes
+    if (bits_per_axis > 21) {
+      Log::Fatal("Grid::UpdateBoxZOrder",
+                 "Number of boxes per axis exceeds the maximum supported "
+                 "by 64 bit morton codes (2^21).");
+    }
+
+    // collect non-empty boxes; each thread processes a contiguous range of
+    // boxes and writes its results to a contiguous range in the output
+    const uint64_t num_boxes = boxes_.size();
+    std::vector<uint64_t> thread_offsets;
+#pragma omp parallel
+    {
+      const uint64_t tid = omp_get_thread_num();
+      const uint64_t num_threads = omp_get_num_threads();
+#pragma omp single
+      thread_offsets.resize(num_threads + 1);
+      // implicit barrier
+
+      const uint64_t chunk = (num_boxes + num_threads - 1) / num_threads;
+      const uint64_t start = std::min(num_boxes, tid * chunk);
+      const uint64_t end = std::min(num_boxes, start + chunk);
+      uint64_t count = 0;
+      for (uint64_t i = start; i < end; i++) {
+        if (!boxes_[i].IsEmpty() && !IsGhostBox(i)) {
+          count++;
+        }
+      }
+      thread_offsets[tid + 1] = count;
+#pragma omp barrier
+
+#pragma omp single
+      {
+        thread_offsets[0] = 0;
+        for (uint64_t t = 1; t <= num_threads; t++) {
+          thread_offsets[t] += thread_offsets[t - 1];
+        }
+        zorder_sorted_boxes_.resize(thread_offsets[num_threads]);
+      }
+      // implicit barrier
+
+      auto idx = thread_offsets[tid];
+      for (uint64_t i = start; i < end; i++) {
+        if (!boxes_[i].IsEmpty() && !IsGhostBox(i)) {
+          auto coord = GetBoxCoordinates(i);
+          auto morton =
+              libmorton::morton3D_64_encode(coord[0], coord[1], coord[2]);
+          zorder_sorted_boxes_[idx++] = {morton, i};
         }
       }
     }
-#ifdef LINUX
-    __gnu_parallel::sort(
-        zorder_sorted_boxes_.begin(), zorder_sorted_boxes_.end(),
-        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
-#else
-    std::sort(
-        zorder_sorted_boxes_.begin(), zorder_sorted_boxes_.end(),
-        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
-#endif  // LINUX
+
+    ParallelRadixSort(&zorder_sorted_boxes_, &zorder_buffer_,
+                      3 * bits_per_axis,
+                      [](const auto& pair) { return pair.first; });
+  }
+
+  /// An iterator that iterates over all simulation objects in the grid.
+  /// Boxes are visited in Z-order (see `Grid::UpdateBoxZOrder`). There is no
+  /// particular order for simulation objects inside a box.
+  struct ZOrderIterator {
+    explicit ZOrderIterator(const Grid* grid)
+        : grid_(grid), box_iterator_(grid, GetBox(0)) {
+      if (grid_->zorder_sorted_boxes_.size() == 0) {
+        is_end_ = true;
+      }
+    }
+
+    bool IsAtEnd() const { return is_end_; }
+
+    SoHandle operator*() const { return *box_iterator_; }
+
+    ZOrderIterator& operator++() {
+      ++box_iterator_;
+      // all sorted boxes are non-empty
+      if (box_iterator_.IsAtEnd()) {
+        if (++box_idx_ < grid_->zorder_sorted_boxes_.size()) {
+          box_iterator_ = typename Box::Iterator(grid_, GetBox(box_idx_));
+        } else {
+          is_end_ = true;
+        }
+      }
+      return *this;
+    }
+
+   private:
+    const Grid* grid_;
+    /// The box that is currently iterated over
+    typename Box::Iterator box_iterator_;
+    /// Index into `Grid::zorder_sorted_boxes_`
+    uint64_t box_idx_ = 0;
+    bool is_end_ = false;
+
+    const Box* GetBox(uint64_t i) const {
+      if (i >= grid_->zorder_sorted_boxes_.size()) {
+        // empty grid; the returned box is never dereferenced
+        return &grid_->empty_box_;
+      }
+      return &grid_->boxes_[grid_->zorder_sorted_boxes_[i].second];
+    }
+  };
+
+  /// Sorts the boxes in Z-order and returns an iterator over all simulation
+  /// objects (see `ZOrderIterator`).
+  ZOrderIterator GetZOrderIterator() {
+    UpdateBoxZOrder();
+    return ZOrderIterator(this);
   }
 
   /// This method iterates over all elements. Iteration is performed in
   /// Z-order of boxes. There is no particular order for elements inside a box.
   template <typename Lambda>
   void IterateZOrder(const Lambda& lambda) {
-    UpdateBoxZOrder();
-    for (uint64_t i = 0; i < zorder_sorted_boxes_.size(); i++) {
-      auto it = zorder_sorted_boxes_[i].second->begin();
-      while (!it.IsAtEnd()) {
-        lambda(*it);
-        ++it;
-      }
+    for (auto it = GetZOrderIterator(); !it.IsAtEnd(); ++it) {
+      lambda(*it);
     }
   }
 
   /// @brief      Applies the given lambda to each neighbor
   ///
-  /// @param[in]  lambda  The operation as a lambda
+  /// In simulation code do not use this function directly. Use the same
+  /// function from the exeuction context (e.g. `InPlaceExecutionContext`)
+  ///
+  /// @param[in]  lambda  Called with `(const SimObject* neighbor)` or with
+  ///                     `(const SimObject* neighbor, double squared_distance)`
   /// @param      query   The query object
+  template <typename TLambda>
+  void ForEachNeighbor(const TLambda& lambda, const SimObject& query) const {
+    ForEachNeighbor(lambda, query, is_neighbor_distance_functor<TLambda>());
+  }
+
   void ForEachNeighbor(const std::function<void(const SimObject*)>& lambda,
                        const SimObject& query) const {
-    auto idx = query.GetBoxIdx();
-
-    FixedSizeVector<const Box*, 27> neighbor_boxes;
-    GetMooreBoxes(&neighbor_boxes, idx);
-
-    auto* rm = Simulation::GetActive()->GetResourceManager();
+    ForEachNeighbor(lambda, query, std::false_type());
+  }
 
-    NeighborIterator ni(neighbor_boxes);
-    while (!ni.IsAtEnd()) {
-      auto* sim_object = rm->GetSimObjectWithSoHandle(*ni);
-      if (sim_object != &query) {
-        lambda(sim_object);
-      }
-      ++ni;
-    }
+  void ForEachNeighbor(
+      const std::function<void(const SimObject*, double)>& lambda,
+      const SimObject& query) const {
+    ForEachNeighbor(lambda, query, std::true_type());
   }
 
   /// @brief      Applies the given lambda to each neighbor or the specified
@@ -470,70 +705,401 @@ class Grid {
   /// In simulation code do not use this function directly. Use the same
   /// function from the exeuction context (e.g. `InPlaceExecutionContext`)
   ///
+  /// Neighbor boxes that do not intersect the search sphere are skipped.
+  ///
   /// @param[in]  lambda  The operation as a lambda
   /// @param      query   The query object
+  /// @param[in]  squared_radius  The search radius squared
   ///
-  void ForEachNeighbor(
-      const std::function<void(const SimObject*, double)>& lambda,
-      const SimObject& query) {
+  template <typename TLambda>
+  void ForEachNeighborWithinRadius(const TLambda& lambda,
+                                   const SimObject& query,
+                                   double squared_radius) {
     const auto& position = query.GetPosition();
     auto idx = query.GetBoxIdx();
 
-    FixedSizeVector<const Box*, 27> neighbor_boxes;
-    GetMooreBoxes(&neighbor_boxes, idx);
+    uint64_t visited = 0;
+    uint64_t accepted = 0;
+    uint64_t skipped_boxes = 0;
+
+    const double verlet_radius = verlet_list_.GetInteractionRadius();
+    if (verlet_list_.IsBuilt() &&
+        squared_radius <= verlet_radius * verlet_radius) {
+      auto* rm = Simulation::GetActive()->GetResourceManager();
+      verlet_list_.ForEachNeighbor(
+          rm->GetSoHandle(query.GetUid()), [&](SoHandle neighbor) {
+            auto* sim_object = rm->GetSimObjectWithSoHandle(neighbor);
+            visited++;
+            if (this->WithinSquaredEuclideanDistance(
+                    squared_radius, position, sim_object->GetPosition())) {
+              accepted++;
+              lambda(sim_object);
+            }
+          });
+    } else if (sorted_cell_list_) {
+      ForEachNeighborBoxWithinRadius(
+          idx, position, squared_radius, &skipped_boxes, [&](size_t box) {
+            auto end = box_offsets_[box + 1];
+            for (auto i = box_offsets_[box]; i < end; i++) {
+              const auto& entry = sorted_entries_[i];
+              if (entry.so_ != &query) {
+                visited++;
+                if (this->WithinSquaredEuclideanDistance(
+                        squared_radius, position, entry.so_->GetPosition())) {
+                  accepted++;
+                  lambda(entry.so_);
+                }
+              }
+            }
+          });
+    } else {
+      auto* rm = Simulation::GetActive()->GetResourceManager();
+      ForEachNeighborBoxWithinRadius(
+          idx, position, squared_radius, &skipped_boxes, [&](size_t box) {
+            Box::Iterator it(this, &boxes_[box]);
+            while (!it.IsAtEnd()) {
+              // Do something with neighbor object
+              auto* sim_object = rm->GetSimObjectWithSoHandle(*it);
+              if (sim_object != &query) {
+                visited++;
+                const auto& neighbor_position = sim_object->GetPosition();
+                if (this->WithinSquaredEuclideanDistance(
+                        squared_radius, position, neighbor_position)) {
+                  accepted++;
+                  lambda(sim_object);
+                }
+              }
+              ++it;
+            }
+          });
+    }
+
+    if (collect_statistics_) {
+      auto& stats = neighbor_statistics_[omp_get_thread_num()];
+      stats[0] += visited;
+      stats[1] += accepted;
+      stats[2] += skipped_boxes;
+    }
+  }
+
+  void ForEachNeighborWithinRadius(
+      const std::function<void(const SimObject*)>& lambda,
+      const SimObject& query, double squared_radius) {
+    ForEachNeighborWithinRadius<std::function<void(const SimObject*)>>(
+        lambda, query, squared_radius);
+  }
+
+  /// Result of a k-nearest neighbor query (see `GetKNearestNeighbors`)
+  struct NearestNeighbor {
+    SimObject* so_;
+    SoHandle handle_;
+    double squared_distance_;
+  };
+
+  /// @brief      Applies the given lambda to each simulation object within
+  ///             the given radius around an arbitrary position.
+  ///
+  /// In contrast to `ForEachNeighborWithinRadius`, the radius is not limited
+  /// to the neighbor boxes and no simulation object is required at the
+  /// query position.
+  ///
+  /// @param[in]  lambda    Called with `(SimObject* so, SoHandle handle,
+  ///                       double squared_distance)`
+  /// @param[in]  position  The query position
+  /// @param[in]  squared_radius  The search radius squared
+  ///
+  template <typename TLambda>
+  void ForEachSimObjectWithinRadius(const TLambda& lambda,
+                                    const Double3& position,
+                                    double squared_radius) const {
+    if (boxes_.size() == 0) {
+      return;
+    }
+    auto* rm = Simulation::GetActive()->GetResourceManager();
+    std::array<int64_t, 3> center;
+    std::array<int64_t, 3> lower;
+    std::array<int64_t, 3> upper;
+    GetQueryBoxRange(position, &center, &lower, &upper);
+
+    double radius = std::sqrt(squared_radius) + GetPositionSlack();
+    int64_t max_ring = std::ceil(radius / box_length_);
+    // rings beyond the range of valid offsets do not contain any boxes
+    int64_t max_extent = 0;
+    for (int i = 0; i < 3; i++) {
+      max_extent = std::max(max_extent, std::max(-lower[i], upper[i]));
+    }
+    max_ring = std::min(max_ring, max_extent);
+    for (int64_t ring = 0; ring <= max_ring; ring++) {
+      ForEachBoxInRing(center, lower, upper, ring, [&](uint64_t box_idx) {
+        Box::Iterator it(this, &boxes_[box_idx]);
+        while (!it.IsAtEnd()) {
+          auto handle = *it;
+          auto* so = rm->GetSimObjectWithSoHandle(handle);
+          double squared_distance =
+              SquaredEuclideanDistance(position, so->GetPosition());
+          if (squared_distance < squared_radius) {
+            lambda(so, handle, squared_distance);
+          }
+          ++it;
+        }
+      });
+    }
+  }
+
+  /// @brief      Batched version of `ForEachSimObjectWithinRadius`. Query
+  ///             positions are processed in parallel.
+  ///
+  /// @param[in]  lambda     Called with `(uint64_t query_idx, SimObject* so,
+  ///                        SoHandle handle, double squared_distance)`.
+  ///                        Must be thread-safe.
+  /// @param[in]  positions  The query positions
+  /// @param[in]  squared_radius  The search radius squared
+  ///
+  template <typename TLambda>
+  void ForEachSimObjectWithinRadius(const TLambda& lambda,
+                                    const std::vector<Double3>& positions,
+                                    double squared_radius) const {
+#pragma omp parallel for schedule(dynamic, 16)
+    for (uint64_t i = 0; i < positions.size(); i++) {
+      ForEachSimObjectWithinRadius(
+          [&](SimObject* so, SoHandle handle, double squared_distance) {
+            lambda(i, so, handle, squared_distance);
+          },
+          positions[i], squared_radius);
+    }
+  }
 
+  /// @brief      Finds the k simulation objects that are closest to an
+  ///             arbitrary position.
+  ///
+  /// Boxes are visited in rings of increasing distance around the box of the
+  /// query position. The search stops as soon as the remaining rings cannot
+  /// contain a closer simulation object.
+  ///
+  /// @param[in]  position  The query position
+  /// @param[in]  k         Number of simulation objects to find
+  /// @param      result    The nearest simulation objects sorted by
+  ///                       ascending distance. Contains less than `k`
+  ///                       elements if the simulation has less than `k`
+  ///                       simulation objects.
+  ///
+  void GetKNearestNeighbors(const Double3& position, uint64_t k,
+                            std::vector<NearestNeighbor>* result) const {
+    result->clear();
+    if (boxes_.size() == 0 || k == 0) {
+      return;
+    }
     auto* rm = Simulation::GetActive()->GetResourceManager();
+    std::array<int64_t, 3> center;
+    std::array<int64_t, 3> lower;
+    std::array<int64_t, 3> upper;
+    GetQueryBoxRange(position, &center, &lower, &upper);
+    int64_t max_ring = 0;
+    for (int i = 0; i < 3; i++) {
+      max_ring = std::max(max_ring, std::max(-lower[i], upper[i]));
+    }
 
-    NeighborIterator ni(neighbor_boxes);
-    while (!ni.IsAtEnd()) {
-      // Do something with neighbor object
-      auto* sim_object = rm->GetSimObjectWithSoHandle(*ni);
-      if (sim_object != &query) {
-        const auto& neighbor_position = sim_object->GetPosition();
-        double squared_distance =
-            SquaredEuclideanDistance(position, neighbor_position);
-        lambda(sim_object, squared_distance);
+    // max heap on the squared distance
+    auto compare = [](const NearestNeighbor& lhs, const NearestNeighbor& rhs) {
+      return lhs.squared_distance_ < rhs.squared_distance_;
+    };
+    const double slack = GetPositionSlack();
+    for (int64_t ring = 0; ring <= max_ring; ring++) {
+      ForEachBoxInRing(center, lower, upper, ring, [&](uint64_t box_idx) {
+        Box::Iterator it(this, &boxes_[box_idx]);
+        while (!it.IsAtEnd()) {
+          auto handle = *it;
+          auto* so = rm->GetSimObjectWithSoHandle(handle);
+          double squared_distance =
+              SquaredEuclideanDistance(position, so->GetPosition());
+          if (result->size() < k) {
+            result->push_back({so, handle, squared_distance});
+            std::push_heap(result->begin(), result->end(), compare);
+          } else if (squared_distance < result->front().squared_distance_) {
+            std::pop_heap(result->begin(), result->end(), compare);
+            result->back() = {so, handle, squared_distance};
+            std::push_heap(result->begin(), result->end(), compare);
+          }
+          ++it;
+        }
+      });
+      // simulation objects in the remaining rings are at least
+      // `ring * box_length_` away from the query position
+      double min_distance = std::max(ring * box_length_ - slack, 0.0);
+      if (result->size() == k &&
+          result->front().squared_distance_ <= min_distance * min_distance) {
+        break;
       }
-      ++ni;
     }
+    std::sort_heap(result->begin(), result->end(), compare);
   }
 
-  /// @brief      Applies the given lambda to each neighbor or the specified
-  ///             simulation object.
+  /// @brief      Batched version of `GetKNearestNeighbors`. Query positions
+  ///             are processed in parallel.
   ///
-  /// In simulation code do not use this function directly. Use the same
-  /// function from the exeuction context (e.g. `InPlaceExecutionContext`)
+  /// @param[in]  positions  The query positions
+  /// @param[in]  k          Number of simulation objects to find
+  /// @param      results    One result for each query position
   ///
-  /// @param[in]  lambda  The operation as a lambda
-  /// @param      query   The query object
+  void GetKNearestNeighbors(
+      const std::vector<Double3>& positions, uint64_t k,
+      std::vector<std::vector<NearestNeighbor>>* results) const {
+    results->resize(positions.size());
+#pragma omp parallel for schedule(dynamic, 16)
+    for (uint64_t i = 0; i < positions.size(); i++) {
+      GetKNearestNeighbors(positions[i], k, &(*results)[i]);
+    }
+  }
+
+  /// @brief      Applies the given lambda exactly once to each unordered pair
+  ///             of simulation objects that are within the given radius.
+  ///
+  /// Pairs are formed between each box and its half neighborhood (see
+  /// `GetHalfNeighborBoxOffsets`). Boxes are partitioned into color classes
+  /// that are processed one after another. Boxes with the same color are
+  /// processed in parallel; their half neighborhoods do not overlap.
+  /// Therefore, `lambda` can modify data of both simulation objects without
+  /// synchronization.
+  ///
+  /// @param[in]  lambda  Called with `(SimObject* lhs, SoHandle lhs_handle,
+  ///                     SimObject* rhs, SoHandle rhs_handle)`
   /// @param[in]  squared_radius  The search radius squared
   ///
-  void ForEachNeighborWithinRadius(
-      const std::function<void(const SimObject*)>& lambda,
-      const SimObject& query, double squared_radius) {
-    const auto& position = query.GetPosition();
-    auto idx = query.GetBoxIdx();
-
-    FixedSizeVector<const Box*, 27> neighbor_boxes;
-    GetMooreBoxes(&neighbor_boxes, idx);
+  template <typename TLambda>
+  void ForEachNeighborPairWithinRadius(const TLambda& lambda,
+                                       double squared_radius) {
+    auto* rm = Simulation::GetActive()->GetResourceManager();
+    ForEachBoxByColor([&](uint64_t box_idx) {
+      Box::Iterator it(this, &boxes_[box_idx]);
+      while (!it.IsAtEnd()) {
+        auto lhs_handle = *it;
+        auto* lhs = rm->GetSimObjectWithSoHandle(lhs_handle);
+        const auto& lhs_position = lhs->GetPosition();
+        for (auto offset : half_neighbor_box_offsets_) {
+          Box::Iterator nit(this, &boxes_[box_idx + offset]);
+          if (offset == 0) {
+            // pairs inside the same box: only consider successors
+            nit = it;
+            ++nit;
+          }
+          while (!nit.IsAtEnd()) {
+            auto rhs_handle = *nit;
+            auto* rhs = rm->GetSimObjectWithSoHandle(rhs_handle);
+            if (WithinSquaredEuclideanDistance(squared_radius, lhs_position,
+                                               rhs->GetPosition())) {
+              lambda(lhs, lhs_handle, rhs, rhs_handle);
+            }
+            ++nit;
+          }
+        }
+        ++it;
+      }
+    });
+  }
 
+  /// @brief      Applies the given lambda to each simulation object in the
+  ///             grid without the need for neighbor mutexes.
+  ///
+  /// Boxes are processed in color classes (see `ForEachBoxByColor`). The
+  /// neighborhoods of two boxes with the same color do not overlap.
+  /// Therefore, `lambda` can modify the simulation object and its neighbors
+  /// without synchronization. Simulation objects inside the same box are
+  /// processed sequentially by the same thread.
+  ///
+  /// @param[in]  lambda  Called with `(SimObject* so, SoHandle handle)`
+  ///
+  template <typename TLambda>
+  void ApplyOnAllElementsByBoxColor(const TLambda& lambda) {
     auto* rm = Simulation::GetActive()->GetResourceManager();
+    ForEachBoxByColor([&](uint64_t box_idx) {
+      Box::Iterator it(this, &boxes_[box_idx]);
+      while (!it.IsAtEnd()) {
+        auto handle = *it;
+        lambda(rm->GetSimObjectWithSoHandle(handle), handle);
+        ++it;
+      }
+    });
+  }
 
-    NeighborIterator ni(neighbor_boxes);
-    while (!ni.IsAtEnd()) {
-      // Do something with neighbor object
-      auto* sim_object = rm->GetSimObjectWithSoHandle(*ni);
-      if (sim_object != &query) {
-        const auto& neighbor_position = sim_object->GetPosition();
-        if (this->WithinSquaredEuclideanDistance(squared_radius, position,
-                                                 neighbor_position)) {
-          lambda(sim_object);
+  /// @brief      Applies the given lambda to each non-empty box.
+  ///
+  /// Boxes are partitioned into `(2 * num_rings + 1)^3` color classes (27
+  /// for one layer of neighbor boxes). Two boxes have the same color if their
+  /// distance along each axis is a multiple of `2 * num_rings + 1`.
+  /// Hence, the neighborhoods of two boxes with the same color are disjoint.
+  /// Colors are processed one after another; boxes of the same color are
+  /// processed in parallel.
+  /// With periodic boundaries, boxes at opposite faces are neighbors. If the
+  /// number of inner boxes along an axis is not a multiple of
+  /// `2 * num_rings + 1`, each of the remaining boxes gets a color of its
+  /// own along this axis. Padding boxes are never visited.
+  ///
+  /// @param[in]  lambda  Called with `(uint64_t box_idx)`
+  ///
+  template <typename TLambda>
+  void ForEachBoxByColor(const TLambda& lambda) const {
+    const int64_t stride = 2 * num_rings_ + 1;
+    // per axis: first inner box, end of the boxes with regular colors, and
+    // the number of boxes with a color of their own
+    std::array<int64_t, 3> begin;
+    std::array<int64_t, 3> end;
+    std::array<int64_t, 3> remainder;
+    for (int i = 0; i < 3; i++) {
+      const int64_t num_inner = static_cast<int64_t>(num_boxes_axis_[i]) -
+                                2 * static_cast<int64_t>(num_rings_);
+      begin[i] = num_rings_;
+      remainder[i] = periodic_ ? num_inner % stride : 0;
+      end[i] = begin[i] + num_inner - remainder[i];
+    }
+    // start, stop, and step along an axis for the given color
+    auto range = [&](int i, int64_t color) {
+      if (color < stride) {
+        return std::array<int64_t, 3>{begin[i] + color, end[i], stride};
+      }
+      auto coord = end[i] + color - stride;
+      return std::array<int64_t, 3>{coord, coord + 1, 1};
+    };
+    const int64_t nx = num_boxes_axis_[0];
+    for (int64_t cz = 0; cz < stride + remainder[2]; cz++) {
+      for (int64_t cy = 0; cy < stride + remainder[1]; cy++) {
+        for (int64_t cx = 0; cx < stride + remainder[0]; cx++) {
+          const auto rx = range(0, cx);
+          const auto ry = range(1, cy);
+          const auto rz = range(2, cz);
+#pragma omp parallel for collapse(3) schedule(dynamic, 1)
+          for (int64_t z = rz[0]; z < rz[1]; z += rz[2]) {
+            for (int64_t y = ry[0]; y < ry[1]; y += ry[2]) {
+              for (int64_t x = rx[0]; x < rx[1]; x += rx[2]) {
+                uint64_t box_idx = z * num_boxes_xy_ + y * nx + x;
+                if (!boxes_[box_idx].IsEmpty()) {
+                  lambda(box_idx);
+                }
+              }
+            }
+          }
         }
       }
-      ++ni;
     }
   }
 
+  /// Returns the Verlet list (see `Param::verlet_skin_`)
+  const VerletList& GetVerletList() const { return verlet_list_; }
+
+  /// Returns the sorted index offsets of the box itself and all its neighbor
+  /// boxes.
+  const std::vector<int64_t>& GetNeighborBoxOffsets() const {
+    return neighbor_box_offsets_;
+  }
+
+  /// Returns the index offsets of the box itself and all neighbor boxes with
+  /// a larger index. Visiting this half neighborhood for each box covers
+  /// each pair of neighboring boxes exactly once.
+  /// For one layer of boxes and `kHigh` adjacency these are the 14 boxes of
+  /// `GetHalfMooreBoxIndices`.
+  const std::vector<int64_t>& GetHalfNeighborBoxOffsets() const {
+    return half_neighbor_box_offsets_;
+  }
+
   /// @brief      Return the box index in the one dimensional array of the box
   ///             that contains the position
   ///
@@ -543,6 +1109,10 @@ class Grid {
   ///
   size_t GetBoxIndex(const Double3& position) const {
     std::array<uint32_t, 3> box_coord;
+    if (periodic_) {
+      GetPeriodicBoxCoordinates(position, &box_coord);
+      return GetBoxIndex(box_coord);
+    }
     box_coord[0] = (floor(position[0]) - grid_dimensions_[0]) / box_length_;
     box_coord[1] = (floor(position[1]) - grid_dimensions_[2]) / box_length_;
     box_coord[2] = (floor(position[2]) - grid_dimensions_[4]) / box_length_;
@@ -599,68 +1169,198 @@ class Grid {
     (*grid_dimensions)[2] = grid_dimensions_[4];
   }
 
-  // NeighborMutex ---------------------------------------------------------
-
-  /// This class ensures thread-safety for the InPlaceExecutionContext for the
-  /// case
-  /// that a simulation object modifies its neighbors.
-  class NeighborMutexBuilder {
-   public:
-    /// The NeighborMutex class is a synchronization primitive that can be
-    /// used to protect sim_objects data from being simultaneously accessed by
-    /// multiple threads.
-    class NeighborMutex {
-     public:
-      NeighborMutex(const FixedSizeVector<uint64_t, 27>& mutex_indices,
-                    NeighborMutexBuilder* mutex_builder)
-          : mutex_indices_(mutex_indices), mutex_builder_(mutex_builder) {
-        // Deadlocks occur if mutliple threads try to acquire the same locks,
-        // but in different order.
-        // -> sort to avoid deadlocks - see lock ordering
-        std::sort(mutex_indices_.begin(), mutex_indices_.end());
-      }
-
-      void lock() {  // NOLINT
-        for (auto idx : mutex_indices_) {
-          auto& mutex = mutex_builder_->mutexes_[idx].mutex_;
-          // acquire lock (and spin if another thread is holding it)
-          while (mutex.test_and_set(std::memory_order_acquire)) {
-          }
-        }
-      }
-
-      void unlock() {  // NOLINT
-        for (auto idx : mutex_indices_) {
-          auto& mutex = mutex_builder_->mutexes_[idx].mutex_;
-          mutex.clear(std::memory_order_release);
-        }
-      }
-
-     private:
-      FixedSizeVector<uint64_t, 27> mutex_indices_;
-      NeighborMutexBuilder* mutex_builder_;
-    };
-
-    /// Used to store mutexes in a vector.
-    /// Always creates a new mutex (even for the copy constructor)
-    struct MutexWrapper {
-      MutexWrapper() {}
-      MutexWrapper(const MutexWrapper&) {}
-      std::atomic_flag mutex_ = ATOMIC_FLAG_INIT;
-    };
-
-    void Update() {
-      auto* grid = Simulation::GetActive()->GetGrid();
-      mutexes_.resize(grid->GetNumBoxes());
-    }
-
-    NeighborMutex GetMutex(uint64_t box_idx) {
-      auto* grid = Simulation::GetActive()->GetGrid();
-      FixedSizeVector<uint64_t, 27> box_indices;
-      grid->GetMooreBoxIndices(&box_indices, box_idx);
-      return NeighborMutex(box_indices, this);
-    }
-
+  /// Determines current box based on parameter box_idx and adds it together
+  /// with half of the surrounding boxes to the vector.
+  /// Legend: C = center, N = north, E = east, S = south, W = west, F = front,
+  ///         B = back
+  /// For each box pair which is centro-symmetric only one box is taken --
+  /// e.g. E-W: E, or BNW-FSE: BNW
+  /// NB: for the update mechanism using a CircularBuffer the order is
+  /// important.
+  /// NB: only covers the closest 26 neighboring boxes (`kHigh`, one layer).
+  ///
+  ///        (x-axis to the right \ y-axis up)
+  ///        z=1
+  ///        +-----+----+-----+
+  ///        | BNW | BN | BNE |
+  ///        +-----+----+-----+
+  ///        | NW  | N  | NE  |
+  ///        +-----+----+-----+
+  ///        | FNW | FN | FNE |
+  ///        +-----+----+-----+
+  ///
+  ///        z = 0
+  ///        +-----+----+-----+
+  ///        | BW  | B  | BE  |
+  ///        +-----+----+-----+
+  ///        | W   | C  | E   |
+  ///        +-----+----+-----+
+  ///        | FW  | F  | FE  |
+  ///        +-----+----+-----+
+  ///
+  ///        z = -1
+  ///        +-----+----+-----+
+  ///        | BSW | BS | BSE |
+  ///        +-----+----+-----+
+  ///        | SW  | S  | SE  |
+  ///        +-----+----+-----+
+  ///        | FSW | FS | FSE |
+  ///        +-----+----+-----+
+  ///
+  void GetHalfMooreBoxIndices(FixedSizeVector<size_t, 14>* neighbor_boxes,
+                              size_t box_idx) const {
+    // C
+    neighbor_boxes->push_back(box_idx);
+    // BW
+    neighbor_boxes->push_back(box_idx + num_boxes_axis_[0] - 1);
+    // FNW
+    neighbor_boxes->push_back(box_idx + num_boxes_xy_ - num_boxes_axis_[0] - 1);
+    // NW
+    neighbor_boxes->push_back(box_idx + num_boxes_xy_ - 1);
+    // BNW
+    neighbor_boxes->push_back(box_idx + num_boxes_xy_ + num_boxes_axis_[0] - 1);
+    // B
+    neighbor_boxes->push_back(box_idx + num_boxes_axis_[0]);
+    // FN
+    neighbor_boxes->push_back(box_idx + num_boxes_xy_ - num_boxes_axis_[0]);
+    // N
+    neighbor_boxes->push_back(box_idx + num_boxes_xy_);
+    // BN
+    neighbor_boxes->push_back(box_idx + num_boxes_xy_ + num_boxes_axis_[0]);
+    // E
+    neighbor_boxes->push_back(box_idx + 1);
+    // BE
+    neighbor_boxes->push_back(box_idx + num_boxes_axis_[0] + 1);
+    // FNE
+    neighbor_boxes->push_back(box_idx + num_boxes_xy_ - num_boxes_axis_[0] + 1);
+    // NE
+    neighbor_boxes->push_back(box_idx + num_boxes_xy_ + 1);
+    // BNE
+    neighbor_boxes->push_back(box_idx + num_boxes_xy_ + num_boxes_axis_[0] + 1);
+  }
+
+  // NeighborMutex ---------------------------------------------------------
+
+  /// This class ensures thread-safety for the InPlaceExecutionContext for the
+  /// case
+  /// that a simulation object modifies its neighbors.
+  class NeighborMutexBuilder {
+   public:
+    /// The NeighborMutex class is a synchronization primitive that can be
+    /// used to protect sim_objects data from being simultaneously accessed by
+    /// multiple threads.
+    class NeighborMutex {
+     public:
+      NeighborMutex(uint64_t box_idx, const Grid* grid,
+                    NeighborMutexBuilder* mutex_builder)
+          : box_idx_(box_idx), grid_(grid), mutex_builder_(mutex_builder) {}
+
+      void lock() {  // NOLINT
+        // Deadlocks occur if mutliple threads try to acquire the same locks,
+        // but in different order.
+        // `neighbor_box_offsets_` is sorted -> locks are always acquired in
+        // ascending order - see lock ordering
+        if (grid_->periodic_) {
+          LockPeriodic();
+          return;
+        }
+        for (auto offset : grid_->neighbor_box_offsets_) {
+          auto& mutex = mutex_builder_->mutexes_[box_idx_ + offset].mutex_;
+          // acquire lock (and spin if another thread is holding it)
+          while (mutex.test_and_set(std::memory_order_acquire)) {
+          }
+        }
+      }
+
+      void unlock() {  // NOLINT
+        if (grid_->periodic_) {
+          auto* boxes = WrappedBoxes();
+          for (uint64_t i = 0; i < num_wrapped_boxes_; i++) {
+            mutex_builder_->mutexes_[boxes[i]].mutex_.clear(
+                std::memory_order_release);
+          }
+          return;
+        }
+        for (auto offset : grid_->neighbor_box_offsets_) {
+          auto& mutex = mutex_builder_->mutexes_[box_idx_ + offset].mutex_;
+          mutex.clear(std::memory_order_release);
+        }
+      }
+
+     private:
+      uint64_t box_idx_;
+      const Grid* grid_;
+      NeighborMutexBuilder* mutex_builder_;
+      /// Sorted and unique indices of the neighbor boxes after mapping
+      /// padding boxes to the box they mirror. Only used with periodic
+      /// boundaries. Holds the Moore neighborhood (27 boxes).
+      std::array<uint64_t, 27> wrapped_boxes_;
+      /// Used instead of `wrapped_boxes_` if the neighborhood spans more
+      /// than one ring of boxes
+      std::vector<uint64_t> wrapped_boxes_overflow_;
+      /// Number of valid elements in `WrappedBoxes()`
+      uint64_t num_wrapped_boxes_ = 0;
+
+      uint64_t* WrappedBoxes() {
+        return grid_->neighbor_box_offsets_.size() <= wrapped_boxes_.size()
+                   ? wrapped_boxes_.data()
+                   : wrapped_boxes_overflow_.data();
+      }
+
+      /// Padding boxes share the mutex of the box they mirror. Otherwise,
+      /// two simulation objects at opposite faces could modify the same
+      /// neighbor at the same time.
+      void LockPeriodic() {
+        const auto& offsets = grid_->neighbor_box_offsets_;
+        if (offsets.size() > wrapped_boxes_.size()) {
+          wrapped_boxes_overflow_.resize(offsets.size());
+        }
+        auto* boxes = WrappedBoxes();
+        // insertion sort; most offsets do not wrap around and are sorted
+        // already
+        num_wrapped_boxes_ = 0;
+        for (auto offset : offsets) {
+          auto box = grid_->GetWrappedBoxIndex(box_idx_ + offset);
+          uint64_t i = num_wrapped_boxes_;
+          while (i > 0 && boxes[i - 1] > box) {
+            i--;
+          }
+          // small grids might map several padding boxes to the same box
+          if (i > 0 && boxes[i - 1] == box) {
+            continue;
+          }
+          for (uint64_t j = num_wrapped_boxes_; j > i; j--) {
+            boxes[j] = boxes[j - 1];
+          }
+          boxes[i] = box;
+          num_wrapped_boxes_++;
+        }
+        for (uint64_t i = 0; i < num_wrapped_boxes_; i++) {
+          auto& mutex = mutex_builder_->mutexes_[boxes[i]].mutex_;
+          while (mutex.test_and_set(std::memory_order_acquire)) {
+          }
+        }
+      }
+    };
+
+    /// Used to store mutexes in a vector.
+    /// Always creates a new mutex (even for the copy constructor)
+    struct MutexWrapper {
+      MutexWrapper() {}
+      MutexWrapper(const MutexWrapper&) {}
+      std::atomic_flag mutex_ = ATOMIC_FLAG_INIT;
+    };
+
+    void Update() {
+      auto* grid = Simulation::GetActive()->GetGrid();
+      mutexes_.resize(grid->GetNumBoxes());
+    }
+
+    NeighborMutex GetMutex(uint64_t box_idx) {
+      auto* grid = Simulation::GetActive()->GetGrid();
+      return NeighborMutex(box_idx, grid, this);
+    }
+
    private:
     /// one mutex for each box in `Grid::boxes_`
     std::vector<MutexWrapper> mutexes_;
@@ -695,7 +1395,25 @@ class Grid {
   ///     SoHandle next_element = successors_[current_element];
   SimObjectVector<SoHandle> successors_;
   /// Determines which boxes to search neighbors in (see enum Adjacency)
-  Adjacency adjacency_;
+  Adjacency adjacency_ = kHigh;
+  /// Number of box layers around a box that are searched for neighbors.
+  /// Determined by the box length and the search radius.
+  uint32_t num_rings_ = 1;
+  /// Sorted index offsets of all boxes in the neighborhood of a box
+  /// (including the box itself). Determined by `adjacency_` and `num_rings_`.
+  std::vector<int64_t> neighbor_box_offsets_;
+  /// Non-negative elements of `neighbor_box_offsets_`
+  /// (see `GetHalfNeighborBoxOffsets`)
+  std::vector<int64_t> half_neighbor_box_offsets_;
+  /// Box coordinate offsets (x, y, z) that correspond to the elements in
+  /// `neighbor_box_offsets_`
+  std::vector<std::array<int32_t, 3>> neighbor_box_coord_offsets_;
+  /// Flag to indicate that neighbor search statistics are collected
+  /// (see `Param::statistics_`)
+  bool collect_statistics_ = false;
+  /// Neighbor search counters for each thread (see
+  /// `NeighborSearchStatistics`). Padded to avoid false sharing.
+  std::vector<std::array<uint64_t, 8>> neighbor_statistics_;
   /// The size of the largest object in the simulation
   double largest_object_size_ = 0;
   /// Cube which contains all simulation objects
@@ -708,14 +1426,499 @@ class Grid {
   bool has_grown_ = false;
   /// Flag to indicate if the grid has been initialized or not
   bool initialized_ = false;
-  /// stores pairs of <box morton code,  box pointer> sorted by morton code.
-  ParallelResizeVector<std::pair<uint32_t, const Box*>> zorder_sorted_boxes_;
+  /// Stores pairs of <box morton code, box index> of all non-empty boxes
+  /// sorted by morton code.
+  std::vector<std::pair<uint64_t, uint64_t>> zorder_sorted_boxes_;
+  /// Temporary storage for sorting `zorder_sorted_boxes_`
+  std::vector<std::pair<uint64_t, uint64_t>> zorder_buffer_;
+  /// Box without simulation objects, used by iterators over an empty range
+  Box empty_box_;
+
+  /// Neighbors of each simulation object within the interaction radius plus
+  /// `Param::verlet_skin_`. Only used if the skin is larger than zero.
+  VerletList verlet_list_;
+
+  /// Flag to indicate that periodic boundaries are used
+  /// (see `Param::periodic_boundary_`)
+  bool periodic_ = false;
+  /// Edge length of the periodic simulation space
+  double periodic_length_ = 0;
+
+  /// State of the simulation object at a given `SoHandle` during the last grid
+  /// update. Required for `UpdateGridIncrementally`.
+  struct HandleState {
+    /// Uid of the simulation object that was stored at this handle
+    SoUid uid_ = std::numeric_limits<SoUid>::max();
+    /// Box in which the simulation object was inserted
+    uint32_t box_idx_ = 0;
+    /// Flag to indicate that the simulation object changed its box (or its
+    /// handle) and must be removed from the linked list of its old box
+    bool moved_ = false;
+  };
+  /// One `HandleState` for each simulation object.
+  /// Only used if `Param::incremental_grid_update_` is set.
+  SimObjectVector<HandleState> handle_states_;
+  /// Flag to indicate that the boxes and `handle_states_` are consistent and
+  /// can be updated incrementally
+  bool incremental_update_ready_ = false;
+
+  /// Element of the sorted cell list. Positions are read from the simulation
+  /// object, because it might have been moved since the last grid update.
+  struct SortedEntry {
+    SimObject* so_ = nullptr;
+    SoHandle handle_;
+  };
+  /// Flag to indicate that neighbor searches use the sorted cell list
+  /// (see `Param::sorted_cell_list_`)
+  bool sorted_cell_list_ = false;
+  /// Index of the first element of each box in `sorted_entries_`.
+  /// Has `boxes_.size() + 1` elements; the elements of box `i` are stored in
+  /// the range [box_offsets_[i], box_offsets_[i + 1]).
+  ParallelResizeVector<uint64_t> box_offsets_;
+  /// All simulation objects sorted by box index
+  ParallelResizeVector<SortedEntry> sorted_entries_;
 
   /// Holds instance of NeighborMutexBuilder if it is enabled.
   /// If `DisableNeighborMutexes` has been called this member set to nullptr.
   std::unique_ptr<NeighborMutexBuilder> nb_mutex_builder_ =
       std::make_unique<NeighborMutexBuilder>();
 
+  /// Relinks only simulation objects that changed their box since the last
+  /// update. Boxes that lost simulation objects are rebuilt from their
+  /// remaining elements; all other boxes keep their linked list.
+  /// Simulation objects that were added, or got a new `SoHandle` due to the
+  /// removal of another simulation object, are treated as if they moved.
+  ///
+  /// @return     false if the grid needs to be rebuilt, because a simulation
+  ///             object left the grid dimensions or grew larger than the
+  ///             neighbor search covers. In this case the grid state remains
+  ///             unchanged.
+  bool UpdateGridIncrementally() {
+    auto* rm = Simulation::GetActive()->GetResourceManager();
+    auto* thread_info = ThreadInfo::GetInstance();
+    const auto max_threads = omp_get_max_threads();
+
+    std::vector<std::vector<uint32_t>> dirty_boxes(max_threads);
+    std::vector<std::vector<SoHandle>> moved(max_threads);
+    // avoid false sharing by padding them
+    // assumes 64 byte cache lines (8 * sizeof(double))
+    std::vector<std::array<double, 8>> largest(max_threads, {{0}});
+    std::atomic<bool> rebuild(false);
+
+    // Boxes of removed simulation objects
+    for (int n = 0; n < thread_info->GetNumaNodes(); n++) {
+      for (uint64_t i = rm->GetNumSimObjects(n); i < handle_states_.size(n);
+           i++) {
+        dirty_boxes[0].push_back(handle_states_[SoHandle(n, i)].box_idx_);
+      }
+    }
+    handle_states_.resize();
+
+    rm->ApplyOnAllElementsParallelDynamic(1000, [&](SimObject* so,
+                                                    SoHandle soh) {
+      auto tid = omp_get_thread_num();
+      auto diameter = so->GetDiameter();
+      if (diameter > largest[tid][0]) {
+        largest[tid][0] = diameter;
+      }
+      const auto& position = so->GetPosition();
+      std::array<uint32_t, 3> box_coord;
+      if (diameter > box_length_ * num_rings_) {
+        rebuild = true;
+        return;
+      }
+      if (periodic_) {
+        GetPeriodicBoxCoordinates(position, &box_coord);
+      } else if (!GetInnerBoxCoordinates(position, &box_coord)) {
+        rebuild = true;
+        return;
+      }
+      uint32_t idx = GetBoxIndex(box_coord);
+      auto uid = so->GetUid();
+      auto& state = handle_states_[soh];
+      if (state.uid_ == uid && state.box_idx_ == idx) {
+        return;
+      }
+      if (state.uid_ != std::numeric_limits<SoUid>::max()) {
+        dirty_boxes[tid].push_back(state.box_idx_);
+      }
+      state = {uid, idx, true};
+      so->SetBoxIdx(idx);
+      moved[tid].push_back(soh);
+    });
+
+    if (rebuild) {
+      return false;
+    }
+
+    largest_object_size_ = 0;
+    for (int tid = 0; tid < max_threads; tid++) {
+      if (largest[tid][0] > largest_object_size_) {
+        largest_object_size_ = largest[tid][0];
+      }
+    }
+    has_grown_ = false;
+
+    std::vector<uint32_t> dirty;
+    for (auto& boxes : dirty_boxes) {
+      dirty.insert(dirty.end(), boxes.begin(), boxes.end());
+    }
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+    // Collect the simulation objects that remain inside the dirty boxes.
+    // Must happen before `successors_` is modified.
+    std::vector<std::vector<SoHandle>> remaining(dirty.size());
+#pragma omp parallel for schedule(dynamic, 64)
+    for (uint64_t i = 0; i < dirty.size(); i++) {
+      Box::Iterator it(this, &boxes_[dirty[i]]);
+      while (!it.IsAtEnd()) {
+        auto soh = *it;
+        if (soh.GetElementIdx() < handle_states_.size(soh.GetNumaNode()) &&
+            !handle_states_[soh].moved_) {
+          remaining[i].push_back(soh);
+        }
+        ++it;
+      }
+    }
+
+    successors_.resize();
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (uint64_t i = 0; i < dirty.size(); i++) {
+      auto* box = &boxes_[dirty[i]];
+      box->start_ = SoHandle();
+      box->length_ = 0;
+      for (auto soh : remaining[i]) {
+        box->AddObject(soh, &successors_);
+      }
+    }
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int tid = 0; tid < max_threads; tid++) {
+      for (auto soh : moved[tid]) {
+        auto& state = handle_states_[soh];
+        boxes_[state.box_idx_].AddObject(soh, &successors_);
+        state.moved_ = false;
+      }
+    }
+    return true;
+  }
+
+  /// Builds the sorted cell list from the box lengths (prefix sum) and the
+  /// linked list of each box.
+  void UpdateSortedCellList() {
+    auto* rm = Simulation::GetActive()->GetResourceManager();
+
+    box_offsets_.resize(boxes_.size() + 1);
+    box_offsets_[0] = 0;
+    for (uint64_t i = 0; i < boxes_.size(); i++) {
+      box_offsets_[i + 1] = box_offsets_[i] + boxes_[i].length_;
+    }
+
+    sorted_entries_.resize(box_offsets_[boxes_.size()]);
+#pragma omp parallel for schedule(dynamic, 256)
+    for (uint64_t i = 0; i < boxes_.size(); i++) {
+      auto offset = box_offsets_[i];
+      Box::Iterator it(this, &boxes_[i]);
+      while (!it.IsAtEnd()) {
+        auto& entry = sorted_entries_[offset++];
+        entry.handle_ = *it;
+        entry.so_ = rm->GetSimObjectWithSoHandle(*it);
+        ++it;
+      }
+    }
+  }
+
+  /// Implementation of `ForEachNeighbor` for lambdas that are called with
+  /// the neighbor only
+  template <typename TLambda>
+  void ForEachNeighbor(const TLambda& lambda, const SimObject& query,
+                       std::false_type) const {
+    auto idx = query.GetBoxIdx();
+
+    if (verlet_list_.IsBuilt()) {
+      auto* rm = Simulation::GetActive()->GetResourceManager();
+      verlet_list_.ForEachNeighbor(
+          rm->GetSoHandle(query.GetUid()), [&](SoHandle neighbor) {
+            lambda(rm->GetSimObjectWithSoHandle(neighbor));
+          });
+      return;
+    }
+
+    if (sorted_cell_list_) {
+      ForEachSortedEntry(idx, [&](const SortedEntry& entry) {
+        if (entry.so_ != &query) {
+          lambda(entry.so_);
+        }
+      });
+      return;
+    }
+
+    auto* rm = Simulation::GetActive()->GetResourceManager();
+
+    NeighborIterator ni(this, idx);
+    while (!ni.IsAtEnd()) {
+      auto* sim_object = rm->GetSimObjectWithSoHandle(*ni);
+      if (sim_object != &query) {
+        lambda(sim_object);
+      }
+      ++ni;
+    }
+  }
+
+  /// Implementation of `ForEachNeighbor` for lambdas that are called with
+  /// the neighbor and its squared distance
+  template <typename TLambda>
+  void ForEachNeighbor(const TLambda& lambda, const SimObject& query,
+                       std::true_type) const {
+    const auto& position = query.GetPosition();
+    auto idx = query.GetBoxIdx();
+
+    if (verlet_list_.IsBuilt()) {
+      auto* rm = Simulation::GetActive()->GetResourceManager();
+      verlet_list_.ForEachNeighbor(
+          rm->GetSoHandle(query.GetUid()), [&](SoHandle neighbor) {
+            auto* sim_object = rm->GetSimObjectWithSoHandle(neighbor);
+            lambda(sim_object, SquaredEuclideanDistance(
+                                   position, sim_object->GetPosition()));
+          });
+      return;
+    }
+
+    if (sorted_cell_list_) {
+      ForEachSortedEntry(idx, [&](const SortedEntry& entry) {
+        if (entry.so_ != &query) {
+          lambda(entry.so_, SquaredEuclideanDistance(
+                                position, entry.so_->GetPosition()));
+        }
+      });
+      return;
+    }
+
+    auto* rm = Simulation::GetActive()->GetResourceManager();
+
+    NeighborIterator ni(this, idx);
+    while (!ni.IsAtEnd()) {
+      // Do something with neighbor object
+      auto* sim_object = rm->GetSimObjectWithSoHandle(*ni);
+      if (sim_object != &query) {
+        const auto& neighbor_position = sim_object->GetPosition();
+        double squared_distance =
+            SquaredEuclideanDistance(position, neighbor_position);
+        lambda(sim_object, squared_distance);
+      }
+      ++ni;
+    }
+  }
+
+  /// Applies the given lambda to each `SortedEntry` inside the Moore
+  /// neighborhood of box `box_idx` (including the box itself)
+  template <typename TLambda>
+  void ForEachSortedEntry(size_t box_idx, const TLambda& lambda) const {
+    for (auto offset : neighbor_box_offsets_) {
+      auto neighbor_box = box_idx + offset;
+      auto end = box_offsets_[neighbor_box + 1];
+      for (auto i = box_offsets_[neighbor_box]; i < end; i++) {
+        lambda(sorted_entries_[i]);
+      }
+    }
+  }
+
+  /// Calculates the box coordinates of the given position.
+  ///
+  /// @return     false if the position lies inside the padding boxes or
+  ///             outside the grid.
+  bool GetInnerBoxCoordinates(const Double3& position,
+                              std::array<uint32_t, 3>* box_coord) const {
+    for (int i = 0; i < 3; i++) {
+      double coord = std::floor((std::floor(position[i]) -
+                                 grid_dimensions_[2 * i]) /
+                                box_length_);
+      if (!(coord >= num_rings_ &&
+            coord < static_cast<double>(num_boxes_axis_[i]) - num_rings_)) {
+        return false;
+      }
+      (*box_coord)[i] = coord;
+    }
+    return true;
+  }
+
+  /// Calculates the box coordinates of the given position if periodic
+  /// boundaries are used. Positions outside the bound space are assigned to
+  /// the closest inner box. If the length of the simulation space is not a
+  /// multiple of the box length, the last inner box along each axis also
+  /// contains the remainder.
+  void GetPeriodicBoxCoordinates(const Double3& position,
+                                 std::array<uint32_t, 3>* box_coord) const {
+    for (int i = 0; i < 3; i++) {
+      double coord = std::floor((std::floor(position[i]) -
+                                 grid_dimensions_[2 * i]) /
+                                box_length_);
+      double max_coord =
+          static_cast<double>(num_boxes_axis_[i]) - num_rings_ - 1;
+      (*box_coord)[i] = std::min(std::max(coord, 1.0 * num_rings_), max_coord);
+    }
+  }
+
+  /// Returns true if `box_idx` is a padding box that mirrors an inner box
+  /// (periodic boundaries only).
+  bool IsGhostBox(uint64_t box_idx) const {
+    return periodic_ && GetWrappedBoxIndex(box_idx) != box_idx;
+  }
+
+  /// Returns the index of the inner box that is mirrored by the given
+  /// padding box. Inner boxes are returned unchanged.
+  uint64_t GetWrappedBoxIndex(uint64_t box_idx) const {
+    auto coord = GetBoxCoordinates(box_idx);
+    for (int i = 0; i < 3; i++) {
+      uint32_t num_inner = num_boxes_axis_[i] - 2 * num_rings_;
+      if (coord[i] < num_rings_) {
+        coord[i] += num_inner;
+      } else if (coord[i] >= num_rings_ + num_inner) {
+        coord[i] -= num_inner;
+      }
+    }
+    return GetBoxIndex(coord);
+  }
+
+  /// Copies the linked list head of each inner box at the faces of the grid
+  /// to the padding boxes on the opposite side. Neighbor searches can
+  /// therefore use the same box offsets as without periodic boundaries.
+  void UpdateGhostBoxes() {
+#pragma omp parallel for schedule(static)
+    for (uint64_t i = 0; i < boxes_.size(); i++) {
+      auto source = GetWrappedBoxIndex(i);
+      if (source != i) {
+        boxes_[i] = boxes_[source];
+      }
+    }
+  }
+
+  /// Returns the maximum distance between the position of a simulation
+  /// object and the box it has been assigned to. Simulation objects are moved
+  /// in place by up to `Param::simulation_max_displacement_` after the grid
+  /// update. If the grid update has been skipped, because the Verlet list is
+  /// still valid, they might additionally have moved up to half the skin.
+  double GetPositionSlack() const {
+    auto* param = Simulation::GetActive()->GetParam();
+    double slack = param->simulation_max_displacement_;
+    if (verlet_list_.IsBuilt()) {
+      slack += 0.5 * verlet_list_.GetSkin();
+    }
+    return slack;
+  }
+
+  /// @brief      Calculates the box that contains the query position and
+  ///             the range of box offsets that can be visited from it.
+  ///
+  /// Without periodic boundaries, the offsets are limited by the grid
+  /// dimensions; positions outside the grid are assigned to the closest
+  /// box. With periodic boundaries, the offsets cover each inner box exactly
+  /// once (see `ForEachBoxInRing`).
+  void GetQueryBoxRange(const Double3& position,
+                        std::array<int64_t, 3>* center,
+                        std::array<int64_t, 3>* lower,
+                        std::array<int64_t, 3>* upper) const {
+    if (periodic_) {
+      std::array<uint32_t, 3> coord;
+      GetPeriodicBoxCoordinates(position, &coord);
+      for (int i = 0; i < 3; i++) {
+        int64_t num_inner = num_boxes_axis_[i] - 2 * num_rings_;
+        (*center)[i] = coord[i];
+        (*lower)[i] = -(num_inner - 1) / 2;
+        (*upper)[i] = num_inner - 1 + (*lower)[i];
+      }
+      return;
+    }
+    for (int i = 0; i < 3; i++) {
+      double coord = std::floor((std::floor(position[i]) -
+                                 grid_dimensions_[2 * i]) /
+                                box_length_);
+      int64_t max_coord = num_boxes_axis_[i] - 1;
+      (*center)[i] = std::min(
+          std::max(static_cast<int64_t>(coord), static_cast<int64_t>(0)),
+          max_coord);
+      (*lower)[i] = -(*center)[i];
+      (*upper)[i] = max_coord - (*center)[i];
+    }
+  }
+
+  /// Applies the given lambda to the index of each box whose offset to box
+  /// `center` has a chebyshev norm of `ring` (i.e. the boxes on the surface
+  /// of a cube with edge length `2 * ring + 1`). Offsets are limited to the
+  /// range [lower, upper] along each axis (see `GetQueryBoxRange`). With
+  /// periodic boundaries, coordinates are wrapped to the inner boxes.
+  template <typename TLambda>
+  void ForEachBoxInRing(const std::array<int64_t, 3>& center,
+                        const std::array<int64_t, 3>& lower,
+                        const std::array<int64_t, 3>& upper, int64_t ring,
+                        const TLambda& lambda) const {
+    auto box_index = [&](int64_t ox, int64_t oy, int64_t oz) {
+      std::array<uint32_t, 3> coord;
+      std::array<int64_t, 3> offset = {ox, oy, oz};
+      for (int i = 0; i < 3; i++) {
+        int64_t c = center[i] + offset[i];
+        if (periodic_) {
+          int64_t num_inner = num_boxes_axis_[i] - 2 * num_rings_;
+          if (c < num_rings_) {
+            c += num_inner;
+          } else if (c >= num_rings_ + num_inner) {
+            c -= num_inner;
+          }
+        }
+        coord[i] = c;
+      }
+      return GetBoxIndex(coord);
+    };
+    const int64_t z_begin = std::max(lower[2], -ring);
+    const int64_t z_end = std::min(upper[2], ring);
+    const int64_t y_begin = std::max(lower[1], -ring);
+    const int64_t y_end = std::min(upper[1], ring);
+    for (int64_t oz = z_begin; oz <= z_end; oz++) {
+      for (int64_t oy = y_begin; oy <= y_end; oy++) {
+        if (std::abs(oz) == ring || std::abs(oy) == ring) {
+          for (int64_t ox = std::max(lower[0], -ring);
+               ox <= std::min(upper[0], ring); ox++) {
+            lambda(box_index(ox, oy, oz));
+          }
+        } else {
+          // only the two boxes on the surface of the cube
+          if (-ring >= lower[0]) {
+            lambda(box_index(-ring, oy, oz));
+          }
+          if (ring != 0 && ring <= upper[0]) {
+            lambda(box_index(ring, oy, oz));
+          }
+        }
+      }
+    }
+  }
+
+  /// Builds the Verlet list from the neighbor boxes of each simulation
+  /// object. `CalculateNumRings` ensures that the neighbor boxes cover the
+  /// interaction radius plus the skin.
+  void BuildVerletList(double skin) {
+    auto* sim = Simulation::GetActive();
+    auto* rm = sim->GetResourceManager();
+    double radius =
+        std::max(largest_object_size_, sim->GetParam()->grid_search_radius_);
+    verlet_list_.Build(
+        radius, skin, [&](const SimObject* so, const auto& callback) {
+          const auto& position = so->GetPosition();
+          NeighborIterator ni(this, so->GetBoxIdx());
+          while (!ni.IsAtEnd()) {
+            auto handle = *ni;
+            auto* neighbor = rm->GetSimObjectWithSoHandle(handle);
+            if (neighbor != so) {
+              callback(handle, SquaredEuclideanDistance(
+                                   position, neighbor->GetPosition()));
+            }
+            ++ni;
+          }
+        });
+  }
+
   void CheckGridGrowth() {
     // Determine if the grid dimensions have changed (changed in the sense that
     // the grid has grown outwards)
@@ -837,188 +2040,91 @@ class Grid {
     grid_dimensions_[5] = ceil(grid_dimensions[5]);
   }
 
-  /// @brief      Gets the Moore (i.e adjacent) boxes of the query boxAlso adds
-  /// the
-  ///             query box.
-  ///
-  /// @param[out] neighbor_boxes  The neighbor boxes
-  /// @param[in]  box_idx         The query box
-  ///
-  void GetMooreBoxes(FixedSizeVector<const Box*, 27>* neighbor_boxes,
-                     size_t box_idx) const {
-    neighbor_boxes->push_back(GetBoxPointer(box_idx));
-
-    // Adjacent 6 (top, down, left, right, front and back)
-    if (adjacency_ >= kLow) {
-      neighbor_boxes->push_back(GetBoxPointer(box_idx - num_boxes_xy_));
-      neighbor_boxes->push_back(GetBoxPointer(box_idx + num_boxes_xy_));
-      neighbor_boxes->push_back(GetBoxPointer(box_idx - num_boxes_axis_[0]));
-      neighbor_boxes->push_back(GetBoxPointer(box_idx + num_boxes_axis_[0]));
-      neighbor_boxes->push_back(GetBoxPointer(box_idx - 1));
-      neighbor_boxes->push_back(GetBoxPointer(box_idx + 1));
-    }
-
-    // Adjacent 12
-    if (adjacency_ >= kMedium) {
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx - num_boxes_xy_ - num_boxes_axis_[0]));
-      neighbor_boxes->push_back(GetBoxPointer(box_idx - num_boxes_xy_ - 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx - num_boxes_axis_[0] - 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx + num_boxes_xy_ - num_boxes_axis_[0]));
-      neighbor_boxes->push_back(GetBoxPointer(box_idx + num_boxes_xy_ - 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx + num_boxes_axis_[0] - 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx - num_boxes_xy_ + num_boxes_axis_[0]));
-      neighbor_boxes->push_back(GetBoxPointer(box_idx - num_boxes_xy_ + 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx - num_boxes_axis_[0] + 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx + num_boxes_xy_ + num_boxes_axis_[0]));
-      neighbor_boxes->push_back(GetBoxPointer(box_idx + num_boxes_xy_ + 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx + num_boxes_axis_[0] + 1));
-    }
-
-    // Adjacent 8
-    if (adjacency_ >= kHigh) {
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx - num_boxes_xy_ - num_boxes_axis_[0] - 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx - num_boxes_xy_ - num_boxes_axis_[0] + 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx - num_boxes_xy_ + num_boxes_axis_[0] - 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx - num_boxes_xy_ + num_boxes_axis_[0] + 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx + num_boxes_xy_ - num_boxes_axis_[0] - 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx + num_boxes_xy_ - num_boxes_axis_[0] + 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx + num_boxes_xy_ + num_boxes_axis_[0] - 1));
-      neighbor_boxes->push_back(
-          GetBoxPointer(box_idx + num_boxes_xy_ + num_boxes_axis_[0] + 1));
-    }
+  /// Calculates how many layers of boxes around a box must be searched, such
+  /// that all neighbors within the search radius are found.
+  /// The search radius is the maximum of the largest object size and
+  /// `Param::grid_search_radius_`, plus `Param::verlet_skin_`.
+  uint32_t CalculateNumRings(double largest_object_size) const {
+    auto* param = Simulation::GetActive()->GetParam();
+    double radius = std::max(largest_object_size, param->grid_search_radius_) +
+                    std::max(param->verlet_skin_, 0.0);
+    uint32_t rings = std::ceil(radius / box_length_);
+    return std::max(rings, 1u);
   }
 
-  /// @brief      Gets the box indices of all adjacent boxes. Also adds the
-  ///             query box index.
-  ///
-  /// @param[out] box_indices     Result containing all box indices
-  /// @param[in]  box_idx         The query box
-  ///
-  void GetMooreBoxIndices(FixedSizeVector<uint64_t, 27>* box_indices,
-                          size_t box_idx) const {
-    box_indices->push_back(box_idx);
-
-    // Adjacent 6 (top, down, left, right, front and back)
-    if (adjacency_ >= kLow) {
-      box_indices->push_back(box_idx - num_boxes_xy_);
-      box_indices->push_back(box_idx + num_boxes_xy_);
-      box_indices->push_back(box_idx - num_boxes_axis_[0]);
-      box_indices->push_back(box_idx + num_boxes_axis_[0]);
-      box_indices->push_back(box_idx - 1);
-      box_indices->push_back(box_idx + 1);
-    }
-
-    // Adjacent 12
-    if (adjacency_ >= kMedium) {
-      box_indices->push_back(box_idx - num_boxes_xy_ - num_boxes_axis_[0]);
-      box_indices->push_back(box_idx - num_boxes_xy_ - 1);
-      box_indices->push_back(box_idx - num_boxes_axis_[0] - 1);
-      box_indices->push_back(box_idx + num_boxes_xy_ - num_boxes_axis_[0]);
-      box_indices->push_back(box_idx + num_boxes_xy_ - 1);
-      box_indices->push_back(box_idx + num_boxes_axis_[0] - 1);
-      box_indices->push_back(box_idx - num_boxes_xy_ + num_boxes_axis_[0]);
-      box_indices->push_back(box_idx - num_boxes_xy_ + 1);
-      box_indices->push_back(box_idx - num_boxes_axis_[0] + 1);
-      box_indices->push_back(box_idx + num_boxes_xy_ + num_boxes_axis_[0]);
-      box_indices->push_back(box_idx + num_boxes_xy_ + 1);
-      box_indices->push_back(box_idx + num_boxes_axis_[0] + 1);
-    }
-
-    // Adjacent 8
-    if (adjacency_ >= kHigh) {
-      box_indices->push_back(box_idx - num_boxes_xy_ - num_boxes_axis_[0] - 1);
-      box_indices->push_back(box_idx - num_boxes_xy_ - num_boxes_axis_[0] + 1);
-      box_indices->push_back(box_idx - num_boxes_xy_ + num_boxes_axis_[0] - 1);
-      box_indices->push_back(box_idx - num_boxes_xy_ + num_boxes_axis_[0] + 1);
-      box_indices->push_back(box_idx + num_boxes_xy_ - num_boxes_axis_[0] - 1);
-      box_indices->push_back(box_idx + num_boxes_xy_ - num_boxes_axis_[0] + 1);
-      box_indices->push_back(box_idx + num_boxes_xy_ + num_boxes_axis_[0] - 1);
-      box_indices->push_back(box_idx + num_boxes_xy_ + num_boxes_axis_[0] + 1);
+  /// Calculates the index offsets of all boxes in the neighborhood of a box
+  /// (see `adjacency_` and `num_rings_`). The offsets are sorted in ascending
+  /// order.
+  void UpdateNeighborBoxOffsets() {
+    std::vector<std::pair<int64_t, std::array<int32_t, 3>>> offsets;
+    int32_t r = num_rings_;
+    int64_t nx = num_boxes_axis_[0];
+    int64_t nxy = num_boxes_xy_;
+    for (int32_t z = -r; z <= r; z++) {
+      for (int32_t y = -r; y <= r; y++) {
+        for (int32_t x = -r; x <= r; x++) {
+          int non_zero_axes = (x != 0) + (y != 0) + (z != 0);
+          if (non_zero_axes > static_cast<int>(adjacency_) + 1) {
+            continue;
+          }
+          offsets.push_back({z * nxy + y * nx + x, {x, y, z}});
+        }
+      }
+    }
+    std::sort(
+        offsets.begin(), offsets.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    neighbor_box_offsets_.resize(offsets.size());
+    neighbor_box_coord_offsets_.resize(offsets.size());
+    half_neighbor_box_offsets_.clear();
+    for (uint64_t i = 0; i < offsets.size(); i++) {
+      neighbor_box_offsets_[i] = offsets[i].first;
+      neighbor_box_coord_offsets_[i] = offsets[i].second;
+      if (offsets[i].first >= 0) {
+        half_neighbor_box_offsets_.push_back(offsets[i].first);
+      }
     }
   }
 
-  /// Determines current box based on parameter box_idx and adds it together
-  /// with half of the surrounding boxes to the vector.
-  /// Legend: C = center, N = north, E = east, S = south, W = west, F = front,
-  ///         B = back
-  /// For each box pair which is centro-symmetric only one box is taken --
-  /// e.g. E-W: E, or BNW-FSE: BNW
-  /// NB: for the update mechanism using a CircularBuffer the order is
-  /// important.
-  ///
-  ///        (x-axis to the right \ y-axis up)
-  ///        z=1
-  ///        +-----+----+-----+
-  ///        | BNW | BN | BNE |
-  ///        +-----+----+-----+
-  ///        | NW  | N  | NE  |
-  ///        +-----+----+-----+
-  ///        | FNW | FN | FNE |
-  ///        +-----+----+-----+
-  ///
-  ///        z = 0
-  ///        +-----+----+-----+
-  ///        | BW  | B  | BE  |
-  ///        +-----+----+-----+
-  ///        | W   | C  | E   |
-  ///        +-----+----+-----+
-  ///        | FW  | F  | FE  |
-  ///        +-----+----+-----+
-  ///
-  ///        z = -1
-  ///        +-----+----+-----+
-  ///        | BSW | BS | BSE |
-  ///        +-----+----+-----+
-  ///        | SW  | S  | SE  |
-  ///        +-----+----+-----+
-  ///        | FSW | FS | FSE |
-  ///        +-----+----+-----+
-  ///
-  void GetHalfMooreBoxIndices(FixedSizeVector<size_t, 14>* neighbor_boxes,
-                              size_t box_idx) const {
-    // C
-    neighbor_boxes->push_back(box_idx);
-    // BW
-    neighbor_boxes->push_back(box_idx + num_boxes_axis_[0] - 1);
-    // FNW
-    neighbor_boxes->push_back(box_idx + num_boxes_xy_ - num_boxes_axis_[0] - 1);
-    // NW
-    neighbor_boxes->push_back(box_idx + num_boxes_xy_ - 1);
-    // BNW
-    neighbor_boxes->push_back(box_idx + num_boxes_xy_ + num_boxes_axis_[0] - 1);
-    // B
-    neighbor_boxes->push_back(box_idx + num_boxes_axis_[0]);
-    // FN
-    neighbor_boxes->push_back(box_idx + num_boxes_xy_ - num_boxes_axis_[0]);
-    // N
-    neighbor_boxes->push_back(box_idx + num_boxes_xy_);
-    // BN
-    neighbor_boxes->push_back(box_idx + num_boxes_xy_ + num_boxes_axis_[0]);
-    // E
-    neighbor_boxes->push_back(box_idx + 1);
-    // BE
-    neighbor_boxes->push_back(box_idx + num_boxes_axis_[0] + 1);
-    // FNE
-    neighbor_boxes->push_back(box_idx + num_boxes_xy_ - num_boxes_axis_[0] + 1);
-    // NE
-    neighbor_boxes->push_back(box_idx + num_boxes_xy_ + 1);
-    // BNE
-    neighbor_boxes->push_back(box_idx + num_boxes_xy_ + num_boxes_axis_[0] + 1);
+  /// Calls `lambda` with the index of each neighbor box of box `box_idx` that
+  /// intersects the sphere around `position` with the given squared radius.
+  /// The sphere is enlarged by `GetPositionSlack()`, because simulation
+  /// objects might have left their box since the last grid update.
+  /// The number of skipped boxes is added to `skipped_boxes`.
+  template <typename TLambda>
+  void ForEachNeighborBoxWithinRadius(size_t box_idx, const Double3& position,
+                                      double squared_radius,
+                                      uint64_t* skipped_boxes,
+                                      const TLambda& lambda) const {
+    const double radius = std::sqrt(squared_radius) + GetPositionSlack();
+    const double squared_box_radius = radius * radius;
+    auto center = GetBoxCoordinates(box_idx);
+    // lower corner of box `box_idx` relative to `position`
+    std::array<double, 3> lower;
+    for (int i = 0; i < 3; i++) {
+      lower[i] = grid_dimensions_[2 * i] +
+                 static_cast<double>(center[i]) * box_length_ - position[i];
+    }
+    for (uint64_t n = 0; n < neighbor_box_offsets_.size(); n++) {
+      const auto& coord_offset = neighbor_box_coord_offsets_[n];
+      double squared_distance = 0;
+      for (int i = 0; i < 3; i++) {
+        // distance along axis i between position and the interval
+        // [lo, lo + box_length_) of the neighbor box
+        double lo =
+            lower[i] + coord_offset[i] * static_cast<double>(box_length_);
+        double hi = lo + box_length_;
+        double d = lo > 0 ? lo : (hi < 0 ? -hi : 0);
+        squared_distance += d * d;
+      }
+      // with periodic boundaries the last box along each axis can be larger
+      // than `box_length_`
+      if (squared_distance >= squared_box_radius && !periodic_) {
+        (*skipped_boxes)++;
+        continue;
+      }
+      lambda(box_idx + neighbor_box_offsets_[n]);
+    }
   }
 
   /// @brief      Gets the pointer to the box with the given index
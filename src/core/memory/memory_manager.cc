@@ -0,0 +1,170 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#include "core/memory/memory_manager.h"
+
+#include <sys/mman.h>
+#include <algorithm>
+
+#include "core/util/log.h"
+#include "core/util/numa.h"
+
+namespace bdm {
+
+namespace {
+
+/// The address of this variable identifies the calling thread
+thread_local char thread_token;
+
+}  // namespace
+
+constexpr uint64_t NumaPoolAllocator::kSlabSize;
+constexpr uint64_t NumaPoolAllocator::kSlabHeaderSize;
+constexpr uint64_t NumaPoolAllocator::kBatchSize;
+constexpr uint64_t MemoryManager::kSizeClass;
+constexpr uint64_t MemoryManager::kMaxBlockSize;
+
+NumaPoolAllocator::NumaPoolAllocator(uint64_t block_size)
+    : block_size_(std::max(block_size, sizeof(void*))) {
+  if (block_size_ > kSlabSize - kSlabHeaderSize) {
+    Log::Fatal("NumaPoolAllocator", "Block size ", block_size_,
+               " exceeds the slab size.");
+  }
+  num_thread_caches_ = thread_info_->GetMaxThreads();
+  thread_caches_.reset(new ThreadCache[num_thread_caches_]);
+  central_.reset(new Central[thread_info_->GetNumaNodes()]);
+}
+
+NumaPoolAllocator::~NumaPoolAllocator() {
+  for (int n = 0; n < thread_info_->GetNumaNodes(); n++) {
+    for (auto* slab : central_[n].slabs_) {
+      munmap(slab, kSlabSize);
+    }
+  }
+}
+
+FreeList* NumaPoolAllocator::GetThreadCache(uint64_t tid) {
+  if (tid >= num_thread_caches_) {
+    return nullptr;
+  }
+  auto& cache = thread_caches_[tid];
+  const void* token = &thread_token;
+  auto* owner = cache.owner_.load(std::memory_order_acquire);
+  if (owner == token) {
+    return &cache.free_list_;
+  }
+  if (owner == nullptr && cache.owner_.compare_exchange_strong(
+                              owner, token, std::memory_order_acq_rel)) {
+    return &cache.free_list_;
+  }
+  return nullptr;
+}
+
+void* NumaPoolAllocator::New() {
+  auto tid = static_cast<uint64_t>(omp_get_thread_num());
+  int nid = tid < num_thread_caches_ ? thread_info_->GetNumaNode(tid) : 0;
+  auto& central = central_[nid];
+  auto* thread_cache = GetThreadCache(tid);
+  if (thread_cache == nullptr) {
+    std::lock_guard<std::mutex> lock(central.mutex_);
+    if (central.free_list_.Empty()) {
+      AllocateSlab(nid, &central);
+    }
+    return central.free_list_.Pop();
+  }
+
+  auto& cache = *thread_cache;
+  if (cache.Empty()) {
+    std::lock_guard<std::mutex> lock(central.mutex_);
+    if (central.free_list_.Empty()) {
+      AllocateSlab(nid, &central);
+    }
+    central.free_list_.MoveTo(kBatchSize, &cache);
+  }
+  return cache.Pop();
+}
+
+void NumaPoolAllocator::Delete(void* p) {
+  auto tid = static_cast<uint64_t>(omp_get_thread_num());
+  int owner = GetNumaNode(p);
+  FreeList* thread_cache = nullptr;
+  if (tid < num_thread_caches_ && thread_info_->GetNumaNode(tid) == owner) {
+    thread_cache = GetThreadCache(tid);
+  }
+  if (thread_cache == nullptr) {
+    // remote free
+    auto& central = central_[owner];
+    std::lock_guard<std::mutex> lock(central.mutex_);
+    central.free_list_.Push(p);
+    return;
+  }
+
+  auto& cache = *thread_cache;
+  cache.Push(p);
+  if (cache.Size() > 2 * kBatchSize) {
+    auto& central = central_[owner];
+    std::lock_guard<std::mutex> lock(central.mutex_);
+    cache.MoveTo(kBatchSize, &central.free_list_);
+  }
+}
+
+void NumaPoolAllocator::AllocateSlab(int numa_node, Central* central) {
+  // Map twice the slab size and unmap the parts in front of and behind the
+  // first address that is aligned to kSlabSize. Only the slab stays mapped.
+  uint64_t size = 2 * kSlabSize;
+  void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    Log::Fatal("NumaPoolAllocator", "Allocation of ", size,
+               " bytes on numa node ", numa_node, " failed.");
+  }
+  auto addr = reinterpret_cast<uintptr_t>(memory);
+  auto aligned = (addr + kSlabSize - 1) & ~(kSlabSize - 1);
+  uint64_t head = aligned - addr;
+  uint64_t tail = size - head - kSlabSize;
+  if (head != 0) {
+    munmap(memory, head);
+  }
+  if (tail != 0) {
+    munmap(reinterpret_cast<void*>(aligned + kSlabSize), tail);
+  }
+  auto* slab = reinterpret_cast<char*>(aligned);
+  // bind the pages before they are touched for the first time
+  numa_tonode_memory(slab, kSlabSize, numa_node);
+  central->slabs_.push_back(slab);
+
+  reinterpret_cast<SlabHeader*>(slab)->numa_node_ = numa_node;
+
+  // push in reverse order such that blocks are handed out in address order
+  uint64_t num_blocks = (kSlabSize - kSlabHeaderSize) / block_size_;
+  for (uint64_t i = num_blocks; i > 0; i--) {
+    central->free_list_.Push(slab + kSlabHeaderSize + (i - 1) * block_size_);
+  }
+}
+
+NumaPoolAllocator* MemoryManager::GetAllocator(std::size_t size) {
+  uint64_t idx = (std::max<std::size_t>(size, 1) - 1) / kSizeClass;
+  auto* allocator = allocators_[idx].load(std::memory_order_acquire);
+  if (allocator == nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    allocator = allocators_[idx].load(std::memory_order_relaxed);
+    if (allocator == nullptr) {
+      allocator = new NumaPoolAllocator((idx + 1) * kSizeClass);
+      allocators_[idx].store(allocator, std::memory_order_release);
+    }
+  }
+  return allocator;
+}
+
+}  // namespace bdm
@@ -0,0 +1,222 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef CORE_MEMORY_MEMORY_MANAGER_H_
+#define CORE_MEMORY_MEMORY_MANAGER_H_
+
+#include <omp.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "core/util/thread_info.h"
+
+namespace bdm {
+
+/// Singly linked list of free memory blocks. The link is stored inside the
+/// free block itself.
+class FreeList {
+ public:
+  bool Empty() const { return head_ == nullptr; }
+
+  uint64_t Size() const { return size_; }
+
+  void Push(void* block) {
+    auto* node = static_cast<Node*>(block);
+    node->next_ = head_;
+    head_ = node;
+    size_++;
+  }
+
+  void* Pop() {
+    auto* node = head_;
+    head_ = node->next_;
+    size_--;
+    return node;
+  }
+
+  /// Moves up to `n` blocks from this list to `dest`
+  void MoveTo(uint64_t n, FreeList* dest) {
+    for (uint64_t i = 0; i < n && !Empty(); i++) {
+      dest->Push(Pop());
+    }
+  }
+
+ private:
+  struct Node {
+    Node* next_;
+  };
+
+  Node* head_ = nullptr;
+  uint64_t size_ = 0;
+};
+
+/// Pool allocator for memory blocks of one fixed size.\n
+/// Memory is requested from the operating system in slabs of `kSlabSize`
+/// bytes that are allocated on a specific NUMA node and aligned to
+/// `kSlabSize`. The NUMA node of a block can therefore be obtained from its
+/// address (see `GetNumaNode`).\n
+/// Each thread has a private free list for blocks of its own NUMA node.
+/// Blocks are exchanged in batches with a central free list of the NUMA node
+/// that is protected by a mutex. Blocks that are freed by a thread of a
+/// different NUMA node are returned to the central list of their node.
+/// The private free list is selected by `omp_get_thread_num()`. It is only
+/// used if no other thread has claimed it before (see `GetThreadCache`).
+/// Other callers, e.g. threads that are not managed by OpenMP or threads of
+/// nested parallel regions, use the central free list.
+class NumaPoolAllocator {
+ public:
+  /// Size of a slab in bytes
+  static constexpr uint64_t kSlabSize = 1 << 18;
+  /// Offset of the first block inside a slab. The bytes in front of it hold
+  /// the `SlabHeader`.
+  static constexpr uint64_t kSlabHeaderSize = 64;
+  /// Number of blocks that are moved between a private and the central free
+  /// list at once
+  static constexpr uint64_t kBatchSize = 64;
+
+  explicit NumaPoolAllocator(uint64_t block_size);
+
+  ~NumaPoolAllocator();
+
+  NumaPoolAllocator(const NumaPoolAllocator&) = delete;
+  NumaPoolAllocator& operator=(const NumaPoolAllocator&) = delete;
+
+  /// Returns a block on the NUMA node of the calling thread
+  void* New();
+
+  /// Returns the block to the free list of its NUMA node
+  void Delete(void* p);
+
+  uint64_t GetBlockSize() const { return block_size_; }
+
+  /// Returns the number of slabs that have been allocated on `numa_node`
+  uint64_t GetNumSlabs(int numa_node) const {
+    return central_[numa_node].slabs_.size();
+  }
+
+  /// Returns the NUMA node of a block that has been allocated by a
+  /// `NumaPoolAllocator`
+  static int GetNumaNode(const void* p) {
+    return GetSlabHeader(p)->numa_node_;
+  }
+
+ private:
+  struct SlabHeader {
+    int numa_node_;
+  };
+
+  /// Free list of a thread. Padded to avoid false sharing.
+  /// Assumes 64 byte cache lines.
+  struct ThreadCache {
+    FreeList free_list_;
+    /// Identifies the thread that uses this free list
+    std::atomic<const void*> owner_{nullptr};
+    char padding_[64 - sizeof(FreeList) - sizeof(std::atomic<const void*>)];
+  };
+
+  /// Free blocks and slabs of one NUMA node
+  struct Central {
+    std::mutex mutex_;
+    FreeList free_list_;
+    /// Start address of each allocated slab (for `munmap`)
+    std::vector<void*> slabs_;
+  };
+
+  static SlabHeader* GetSlabHeader(const void* p) {
+    auto addr = reinterpret_cast<uintptr_t>(p) & ~(kSlabSize - 1);
+    return reinterpret_cast<SlabHeader*>(addr);
+  }
+
+  /// Returns the private free list of OpenMP thread `tid` if it belongs to
+  /// the calling thread. The first thread that asks for a free list becomes
+  /// its owner. Returns nullptr if `tid` is out of range or the free list is
+  /// owned by a different thread; the caller must then use the central free
+  /// list.
+  FreeList* GetThreadCache(uint64_t tid);
+
+  /// Allocates a new slab on `numa_node` and adds its blocks to the central
+  /// free list. The caller must hold the lock of `central`.
+  void AllocateSlab(int numa_node, Central* central);
+
+  uint64_t block_size_;
+  ThreadInfo* thread_info_ = ThreadInfo::GetInstance();
+  std::unique_ptr<ThreadCache[]> thread_caches_;
+  uint64_t num_thread_caches_;
+  std::unique_ptr<Central[]> central_;
+};
+
+/// Allocates the memory of simulation objects and biology modules (see
+/// `SimObject::operator new` and `BaseBiologyModule::operator new`).\n
+/// Requests are grouped into size classes of `kSizeClass` bytes, each of
+/// which is served by a `NumaPoolAllocator`. Memory is allocated on the NUMA
+/// node of the calling thread, which is the NUMA node whose container
+/// receives new simulation objects (see `InPlaceExecutionContext`).
+/// Requests larger than `kMaxBlockSize` are forwarded to the global
+/// `operator new`.\n
+/// Memory is not returned to the operating system until the program exits.
+class MemoryManager {
+ public:
+  /// Granularity of the block sizes
+  static constexpr uint64_t kSizeClass = 16;
+  /// Largest block size that is served from a pool
+  static constexpr uint64_t kMaxBlockSize = 2048;
+
+  static MemoryManager* GetInstance() {
+    // Intentionally never deleted: simulation objects that are destroyed
+    // during static deinitialization must still be able to free their memory.
+    static MemoryManager* kInstance = new MemoryManager();
+    return kInstance;
+  }
+
+  void* New(std::size_t size) {
+    if (size > kMaxBlockSize) {
+      return ::operator new(size);
+    }
+    return GetAllocator(size)->New();
+  }
+
+  /// `size` must be the same as in the corresponding call to `New`
+  void Delete(void* p, std::size_t size) {
+    if (p == nullptr) {
+      return;
+    }
+    if (size > kMaxBlockSize) {
+      ::operator delete(p);
+      return;
+    }
+    GetAllocator(size)->Delete(p);
+  }
+
+  /// Returns the allocator of the size class that serves `size` bytes.
+  /// Allocators are created on first use.
+  NumaPoolAllocator* GetAllocator(std::size_t size);
+
+ private:
+  static constexpr uint64_t kNumSizeClasses = kMaxBlockSize / kSizeClass;
+
+  MemoryManager() {}
+
+  std::mutex mutex_;
+  std::array<std::atomic<NumaPoolAllocator*>, kNumSizeClasses> allocators_{};
+};
+
+}  // namespace bdm
+
+#endif  // CORE_MEMORY_MEMORY_MANAGER_H_
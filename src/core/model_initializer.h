@@ -15,6 +15,8 @@
 #ifndef CORE_MODEL_INITIALIZER_H_
 #define CORE_MODEL_INITIALIZER_H_
 
+#include <omp.h>
+#include <array>
 #include <ctime>
 #include <string>
 #include <vector>
@@ -24,6 +26,7 @@
 #include "core/resource_manager.h"
 #include "core/simulation.h"
 #include "core/util/random.h"
+#include "core/util/thread_info.h"
 
 namespace bdm {
 
@@ -153,6 +156,113 @@ struct ModelInitializer {
     }
   }
 
+  /// Parallel version of `Grid3D`. Simulation objects are constructed by all
+  /// threads and stored on the NUMA node of the constructing thread.
+  /// `cell_builder` must be thread safe. In contrast to `Grid3D`, the uids of
+  /// the simulation objects do not follow the order of the grid positions.
+  /// \see `Grid3D`
+  template <typename Function>
+  static void Grid3DParallel(size_t cells_per_dim, double space,
+                             Function cell_builder) {
+    Grid3DParallel({cells_per_dim, cells_per_dim, cells_per_dim}, space,
+                   cell_builder);
+  }
+
+  /// Parallel version of `Grid3D`. Simulation objects are constructed by all
+  /// threads and stored on the NUMA node of the constructing thread.
+  /// `cell_builder` must be thread safe. In contrast to `Grid3D`, the uids of
+  /// the simulation objects do not follow the order of the grid positions.
+  /// \see `Grid3D`
+  template <typename Function>
+  static void Grid3DParallel(const std::array<size_t, 3>& cells_per_dim,
+                             double space, Function cell_builder) {
+    const uint64_t yz = cells_per_dim[1] * cells_per_dim[2];
+    CreateSimObjectsParallel(cells_per_dim[0] * yz, [&](uint64_t i) {
+      double x = i / yz;
+      double y = (i % yz) / cells_per_dim[2];
+      double z = i % cells_per_dim[2];
+      return cell_builder({x * space, y * space, z * space});
+    });
+  }
+
+  /// Parallel version of `CreateCells`. Simulation objects are constructed by
+  /// all threads and stored on the NUMA node of the constructing thread.
+  /// `cell_builder` must be thread safe.
+  /// \see `CreateCells`
+  template <typename Function>
+  static void CreateCellsParallel(const std::vector<Double3>& positions,
+                                  Function cell_builder) {
+    CreateSimObjectsParallel(positions.size(), [&](uint64_t i) {
+      return cell_builder(positions[i]);
+    });
+  }
+
+  /// Parallel version of `CreateCellsRandom`. Each thread draws the positions
+  /// from its own random number generator (see `Simulation::GetAllRandom`).
+  /// Simulation objects are stored on the NUMA node of the constructing
+  /// thread. `cell_builder` must be thread safe.
+  /// \see `CreateCellsRandom`
+  template <typename Function>
+  static void CreateCellsRandomParallel(double min, double max, int num_cells,
+                                        Function cell_builder) {
+    auto& randoms = Simulation::GetActive()->GetAllRandom();
+    CreateSimObjectsParallel(num_cells, [&](uint64_t) {
+      auto* random = randoms[omp_get_thread_num()];
+      double x = random->Uniform(min, max);
+      double y = random->Uniform(min, max);
+      double z = random->Uniform(min, max);
+      return cell_builder({x, y, z});
+    });
+  }
+
+  /// Constructs simulation objects in parallel and adds them to the
+  /// ResourceManager with one bulk insertion per thread.
+  /// Each thread stores its simulation objects on its own NUMA node.
+  ///
+  /// @param[in]  num_sim_objects  The number of simulation objects
+  /// @param[in]  builder          Called with each index in
+  ///                              `[0, num_sim_objects)`; returns a new
+  ///                              simulation object. Must be thread safe.
+  ///
+  template <typename TBuilder>
+  static void CreateSimObjectsParallel(uint64_t num_sim_objects,
+                                       const TBuilder& builder) {
+    auto* rm = Simulation::GetActive()->GetResourceManager();
+    auto* tinfo = ThreadInfo::GetInstance();
+    const int max_threads = tinfo->GetMaxThreads();
+    std::vector<std::vector<SimObject*>> thread_sos(max_threads);
+
+#pragma omp parallel
+    {
+      auto& sos = thread_sos[omp_get_thread_num()];
+      sos.reserve(num_sim_objects / max_threads + 1);
+#pragma omp for schedule(static)
+      for (uint64_t i = 0; i < num_sim_objects; i++) {
+        sos.push_back(builder(i));
+      }
+    }
+
+    // group by numa domain
+    std::vector<uint64_t> so_per_numa(tinfo->GetNumaNodes());
+    std::vector<uint64_t> thread_offsets(max_threads);
+    for (int tid = 0; tid < max_threads; tid++) {
+      int nid = tinfo->GetNumaNode(tid);
+      thread_offsets[tid] = so_per_numa[nid];
+      so_per_numa[nid] += thread_sos[tid].size();
+    }
+    std::vector<uint64_t> numa_offsets(tinfo->GetNumaNodes());
+    for (unsigned n = 0; n < so_per_numa.size(); n++) {
+      numa_offsets[n] = rm->GrowSoContainer(so_per_numa[n], n);
+    }
+
+#pragma omp parallel for schedule(static, 1)
+    for (int tid = 0; tid < max_threads; tid++) {
+      int nid = tinfo->GetNumaNode(tid);
+      rm->AddSimObjects(nid, numa_offsets[nid] + thread_offsets[tid],
+                        thread_sos[tid]);
+    }
+  }
+
   /// Allows cells to secrete the specified substance. Diffusion throughout the
   /// simulation space is automatically taken care of by the DiffusionGrid class
   ///
@@ -162,15 +272,26 @@ struct ModelInitializer {
   /// @param[in]  decay_constant   The decay constant
   /// @param[in]  resolution       The resolution of the diffusion grid
   ///
+  /// The diffusion method is set according to `Param::diffusion_method_`.
+  /// It can be changed afterwards with `DiffusionGrid::SetDiffusionMethod`.
+  ///
   static void DefineSubstance(size_t substance_id, std::string substance_name,
                               double diffusion_coeff, double decay_constant,
                               int resolution = 10) {
     assert(resolution > 0 && "Resolution needs to be a positive integer value");
     auto* sim = Simulation::GetActive();
     auto* rm = sim->GetResourceManager();
+    auto* param = sim->GetParam();
     DiffusionGrid* d_grid =
         new DiffusionGrid(substance_id, substance_name, diffusion_coeff,
                           decay_constant, resolution);
+    if (param->diffusion_method_ == "adi") {
+      d_grid->SetDiffusionMethod(DiffusionGrid::kADI);
+    } else if (param->diffusion_method_ != "euler") {
+      Log::Fatal("ModelInitializer::DefineSubstance",
+                 "Unknown diffusion method '", param->diffusion_method_,
+                 "'. Valid options are \"euler\" and \"adi\".");
+    }
     rm->AddDiffusionGrid(d_grid);
   }
 
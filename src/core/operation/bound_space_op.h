@@ -15,6 +15,8 @@
 #ifndef CORE_OPERATION_BOUND_SPACE_OP_H_
 #define CORE_OPERATION_BOUND_SPACE_OP_H_
 
+#include <cmath>
+
 #include "core/param/param.h"
 #include "core/sim_object/sim_object.h"
 #include "core/simulation.h"
@@ -41,6 +43,46 @@ inline void ApplyBoundingBox(SimObject* sim_object, double lb, double rb) {
   }
 }
 
+/// Moves simulation objects that left the cube [lb, rb) to the corresponding
+/// position on the opposite side (periodic boundary conditions).
+inline void ApplyPeriodicBoundary(SimObject* sim_object, double lb,
+                                  double rb) {
+  double length = rb - lb;
+  auto pos = sim_object->GetPosition();
+  bool updated = false;
+  for (int i = 0; i < 3; i++) {
+    if (pos[i] < lb || pos[i] >= rb) {
+      pos[i] = lb + std::fmod(pos[i] - lb, length);
+      if (pos[i] < lb) {
+        pos[i] += length;
+      }
+      // fmod of a tiny negative value can result in exactly `rb`
+      if (pos[i] >= rb) {
+        pos[i] = lb;
+      }
+      updated = true;
+    }
+  }
+  if (updated) {
+    sim_object->SetPosition(pos);
+  }
+}
+
+/// Applies the boundary condition selected in param.h: the position is
+/// either clamped to the bounds or wrapped around (see
+/// `Param::periodic_boundary_`). Does nothing if the space is not bound.
+inline void ApplyBoundaryCondition(SimObject* sim_object,
+                                   const Param* param) {
+  if (!param->bound_space_) {
+    return;
+  }
+  if (param->periodic_boundary_) {
+    ApplyPeriodicBoundary(sim_object, param->min_bound_, param->max_bound_);
+  } else {
+    ApplyBoundingBox(sim_object, param->min_bound_, param->max_bound_);
+  }
+}
+
 /// Keeps the simulation objects contained within the bounds as defined in
 /// param.h
 class BoundSpace {
@@ -49,10 +91,7 @@ class BoundSpace {
   ~BoundSpace() {}
 
   void operator()(SimObject* sim_object) const {
-    auto* param = Simulation::GetActive()->GetParam();
-    if (param->bound_space_) {
-      ApplyBoundingBox(sim_object, param->min_bound_, param->max_bound_);
-    }
+    ApplyBoundaryCondition(sim_object, Simulation::GetActive()->GetParam());
   }
 };
 
@@ -15,6 +15,8 @@
 #ifndef CORE_OPERATION_DIFFUSION_OP_H_
 #define CORE_OPERATION_DIFFUSION_OP_H_
 
+#include <array>
+#include <map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -41,6 +43,9 @@ class DiffusionOp {
     auto* param = sim->GetParam();
 
     rm->ApplyOnAllDiffusionGrids([&](DiffusionGrid* dg) {
+      // Add the secretion of this iteration before box indices change
+      dg->CommitSecretion();
+
       // Update the diffusion grid dimension if the neighbor grid dimensions
       // have changed. If the space is bound, we do not need to update the
       // dimensions, because these should not be changing anyway
@@ -52,7 +57,29 @@ class DiffusionOp {
         dg->Update(grid->GetDimensionThresholds());
       }
 
-      if (param->leaking_edges_) {
+      auto substeps = param->diffusion_substeps_;
+      if (dg->GetDiffusionMethod() == DiffusionGrid::kADI) {
+        for (uint64_t i = 0; i < substeps; i++) {
+          dg->DiffuseADI(param->leaking_edges_);
+        }
+        if (param->calculate_gradients_) {
+          dg->CalculateGradient();
+        }
+        return;
+      }
+
+      if (dg->IsSparse()) {
+        // only update the bricks with non-negligible concentration
+        for (uint64_t i = 0; i < substeps; i++) {
+          dg->DiffuseEulerSparse(param->leaking_edges_);
+        }
+      } else if (param->fuse_diffusion_grids_) {
+        // the last step is fused with the other diffusion grids
+        dg->DiffuseEulerTimeBlocked(substeps - 1, param->leaking_edges_);
+        return;
+      } else if (substeps > 1) {
+        dg->DiffuseEulerTimeBlocked(substeps, param->leaking_edges_);
+      } else if (param->leaking_edges_) {
         dg->DiffuseEulerLeakingEdge();
       } else {
         dg->DiffuseEuler();
@@ -62,6 +89,21 @@ class DiffusionOp {
         dg->CalculateGradient();
       }
     });
+
+    if (param->fuse_diffusion_grids_) {
+      // group diffusion grids with the same number of boxes
+      std::map<std::array<size_t, 3>, std::vector<DiffusionGrid*>> groups;
+      rm->ApplyOnAllDiffusionGrids([&](DiffusionGrid* dg) {
+        if (dg->GetDiffusionMethod() == DiffusionGrid::kEuler &&
+            !dg->IsSparse()) {
+          groups[dg->GetNumBoxesArray()].push_back(dg);
+        }
+      });
+      for (auto& group : groups) {
+        DiffusionGrid::DiffuseAndCalculateGradients(
+            group.second, param->leaking_edges_, param->calculate_gradients_);
+      }
+    }
   }
 };
 
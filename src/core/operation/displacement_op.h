@@ -18,6 +18,7 @@
 #include <type_traits>
 
 #include "core/operation/displacement_op_cpu.h"
+#include "core/operation/displacement_op_symmetric.h"
 #ifdef USE_CUDA
 #include "core/operation/displacement_op_cuda.h"
 #endif
@@ -43,15 +44,34 @@ class DisplacementOp {
 
   ~DisplacementOp() {}
 
+  /// Returns true if the displacement is calculated for each simulation
+  /// object separately (`operator()(SimObject*)`).
   bool UseCpu() const {
     auto* param = Simulation::GetActive()->GetParam();
-    return force_cpu_implementation_ ||
-           (!param->use_gpu_ && !param->use_opencl_);
+    return !UseSymmetric() && (force_cpu_implementation_ ||
+                               (!param->use_gpu_ && !param->use_opencl_));
+  }
+
+  /// Returns true if the displacement is calculated for all pairs of
+  /// neighbors at once (see `DisplacementOpSymmetric`)
+  bool UseSymmetric() const {
+    auto* param = Simulation::GetActive()->GetParam();
+    return param->symmetric_displacement_;
+  }
+
+  /// Checks once before the simulation starts that the simulation objects
+  /// are supported by the selected implementation
+  void CheckSimObjects() const {
+    if (UseSymmetric()) {
+      symmetric_.CheckSimObjects();
+    }
   }
 
   void operator()() {
     auto* param = Simulation::GetActive()->GetParam();
-    if (param->use_gpu_ && !force_cpu_implementation_) {
+    if (UseSymmetric()) {
+      symmetric_();
+    } else if (param->use_gpu_ && !force_cpu_implementation_) {
 #ifdef USE_OPENCL
       if (param->use_opencl_) {
         auto* rm = Simulation::GetActive()->GetResourceManager();
@@ -87,6 +107,7 @@ class DisplacementOp {
   /// will be set to true.
   bool force_cpu_implementation_ = false;
   DisplacementOpCpu cpu_;
+  DisplacementOpSymmetric symmetric_;
 #ifdef USE_CUDA
   DisplacementOpCuda cuda_;  // NOLINT
 #endif
@@ -61,9 +61,7 @@ class DisplacementOpCpu {
     const auto& displacement =
         sim_object->CalculateDisplacement(squared_radius_, delta_time_);
     sim_object->ApplyDisplacement(displacement);
-    if (param->bound_space_) {
-      ApplyBoundingBox(sim_object, param->min_bound_, param->max_bound_);
-    }
+    ApplyBoundaryCondition(sim_object, param);
   }
 
  private:
@@ -0,0 +1,127 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef CORE_OPERATION_DISPLACEMENT_OP_SYMMETRIC_H_
+#define CORE_OPERATION_DISPLACEMENT_OP_SYMMETRIC_H_
+
+#include <limits>
+
+#include "core/container/sim_object_vector.h"
+#include "core/default_force.h"
+#include "core/grid.h"
+#include "core/operation/bound_space_op.h"
+#include "core/param/param.h"
+#include "core/resource_manager.h"
+#include "core/scheduler.h"
+#include "core/sim_object/cell.h"
+#include "core/simulation.h"
+#include "core/util/log.h"
+#include "core/util/type.h"
+
+namespace bdm {
+
+/// Calculates the mechanical forces between all pairs of neighboring cells
+/// and moves them accordingly.
+/// In contrast to `DisplacementOpCpu`, the force between two cells is
+/// calculated only once and applied to both of them (Newton's third law).
+/// Forces are calculated for the positions at the beginning of this
+/// operation. Therefore, the result does not depend on the order in which
+/// cells are processed.
+/// Currently only supports `Cell`s (see `CheckSimObjects`).
+class DisplacementOpSymmetric {
+ public:
+  DisplacementOpSymmetric() {}
+  ~DisplacementOpSymmetric() {}
+
+  /// Stops the simulation if a simulation object does not derive from `Cell`.
+  /// Called once by `Scheduler::Initialize` instead of each iteration.
+  /// Simulation objects that are added during the simulation are checked by
+  /// `bdm_static_cast` in debug builds.
+  void CheckSimObjects() const {
+    auto* rm = Simulation::GetActive()->GetResourceManager();
+    bool only_cells = true;
+    rm->ApplyOnAllElements([&](SimObject* so) {
+      only_cells = only_cells && dynamic_cast<Cell*>(so) != nullptr;
+    });
+    if (!only_cells) {
+      Log::Fatal("DisplacementOpSymmetric",
+                 "Symmetric displacement only supports simulation objects "
+                 "that derive from Cell.");
+    }
+  }
+
+  void operator()() {
+    auto* sim = Simulation::GetActive();
+    auto* rm = sim->GetResourceManager();
+    auto* grid = sim->GetGrid();
+    auto* param = sim->GetParam();
+
+    auto current_iteration = sim->GetScheduler()->GetSimulatedSteps();
+    auto current_time = (current_iteration + 1) * param->simulation_time_step_;
+    double delta_time = current_time - last_time_run_;
+    last_time_run_ = current_time;
+
+    forces_.resize();
+    rm->ApplyOnAllElementsParallelDynamic(
+        1000, [&](SimObject*, SoHandle soh) { forces_[soh] = {0, 0, 0}; });
+
+    // dormant simulation objects are not moved, but still push their
+    // neighbors away (see `SimObject::Sleep`)
+    auto moves = [](const SimObject* so) {
+      return so->RunDisplacement() && !so->IsDormant();
+    };
+
+    auto search_radius = grid->GetLargestObjectSize();
+    DefaultForce default_force(grid->GetPeriodicLength());
+    grid->ForEachNeighborPairWithinRadius(
+        [&](SimObject* lhs, SoHandle lhs_handle, SimObject* rhs,
+            SoHandle rhs_handle) {
+          bool lhs_moves = moves(lhs);
+          bool rhs_moves = moves(rhs);
+          if (!lhs_moves && !rhs_moves) {
+            return;
+          }
+          auto force4 = default_force.GetForce(lhs, rhs);
+          Double3 force = {force4[0], force4[1], force4[2]};
+          if (lhs_moves) {
+            forces_[lhs_handle] += force;
+          }
+          if (rhs_moves) {
+            forces_[rhs_handle] -= force;
+          }
+        },
+        search_radius * search_radius);
+
+    rm->ApplyOnAllElementsParallelDynamic(1000, [&](SimObject* so,
+                                                    SoHandle soh) {
+      if (!moves(so)) {
+        return;
+      }
+      auto* cell = bdm_static_cast<Cell*>(so);
+      const auto& displacement =
+          cell->CalculateDisplacementFromForce(forces_[soh], delta_time);
+      cell->ApplyDisplacement(displacement);
+      ApplyBoundaryCondition(cell, param);
+    });
+  }
+
+ private:
+  double last_time_run_ = 0;
+  /// Sum of the forces that act on each simulation object
+  SimObjectVector<Double3> forces_;
+};
+
+}  // namespace bdm
+
+#endif  // CORE_OPERATION_DISPLACEMENT_OP_SYMMETRIC_H_
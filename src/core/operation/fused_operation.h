@@ -0,0 +1,63 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef CORE_OPERATION_FUSED_OPERATION_H_
+#define CORE_OPERATION_FUSED_OPERATION_H_
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace bdm {
+
+class SimObject;
+
+/// Executes several operation functors one after another for each simulation
+/// object. In contrast to a sequence of `Operation`s, the functors are not
+/// called through `std::function`. Their types are known at compile time,
+/// which allows the compiler to inline them into one kernel.\n
+/// A `FusedOperation` can be used as the function of an `Operation`:
+///
+///     auto op = Operation("fused", FuseOperations(OpA(), OpB()));
+///
+/// \see `FuseOperations`
+template <typename... TOps>
+class FusedOperation {
+ public:
+  explicit FusedOperation(const TOps&... ops) : ops_(ops...) {}
+
+  void operator()(SimObject* so) {
+    Apply(so, std::index_sequence_for<TOps...>());
+  }
+
+ private:
+  std::tuple<TOps...> ops_;
+
+  template <std::size_t... Is>
+  void Apply(SimObject* so, std::index_sequence<Is...>) {
+    // executes the functors in the given order
+    int expand[] = {0, (std::get<Is>(ops_)(so), 0)...};
+    (void)expand;
+  }
+};
+
+/// Returns a `FusedOperation` that executes `ops` in the given order
+template <typename... TOps>
+FusedOperation<TOps...> FuseOperations(const TOps&... ops) {
+  return FusedOperation<TOps...>(ops...);
+}
+
+}  // namespace bdm
+
+#endif  // CORE_OPERATION_FUSED_OPERATION_H_
@@ -36,6 +36,13 @@ struct Operation {
 
   void operator()(SimObject* so) const;
 
+  /// Returns the stored function if its type is `TFunction`; nullptr
+  /// otherwise (see `std::function::target`)
+  template <typename TFunction>
+  const TFunction* GetFunction() const {
+    return function_.template target<TFunction>();
+  }
+
   /// Specifies how often this operation will be executed.\n
   /// 1: every timestep\n
   /// 2: every second timestep\n
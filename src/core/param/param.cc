@@ -65,9 +65,12 @@ void Param::AssignFromConfig(const std::shared_ptr<cpptoml::table>& config) {
   BDM_ASSIGN_CONFIG_VALUE(bound_space_, "simulation.bound_space");
   BDM_ASSIGN_CONFIG_VALUE(min_bound_, "simulation.min_bound");
   BDM_ASSIGN_CONFIG_VALUE(max_bound_, "simulation.max_bound");
+  BDM_ASSIGN_CONFIG_VALUE(periodic_boundary_, "simulation.periodic_boundary");
   BDM_ASSIGN_CONFIG_VALUE(leaking_edges_, "simulation.leaking_edges");
   BDM_ASSIGN_CONFIG_VALUE(calculate_gradients_,
                           "simulation.calculate_gradients");
+  BDM_ASSIGN_CONFIG_VALUE(diffusion_method_, "simulation.diffusion_method");
+  BDM_ASSIGN_CONFIG_VALUE(diffusion_substeps_, "simulation.diffusion_substeps");
   // visualization group
   BDM_ASSIGN_CONFIG_VALUE(live_visualization_, "visualization.live");
   BDM_ASSIGN_CONFIG_VALUE(export_visualization_, "visualization.export");
@@ -146,9 +149,25 @@ void Param::AssignFromConfig(const std::shared_ptr<cpptoml::table>& config) {
   // performance group
   BDM_ASSIGN_CONFIG_VALUE(scheduling_batch_size_,
                           "performance.scheduling_batch_size");
+  BDM_ASSIGN_CONFIG_VALUE(so_sort_frequency_, "performance.so_sort_frequency");
   BDM_ASSIGN_CONFIG_VALUE(detect_static_sim_objects_,
                           "performance.detect_static_sim_objects");
   BDM_ASSIGN_CONFIG_VALUE(cache_neighbors_, "performance.cache_neighbors");
+  BDM_ASSIGN_CONFIG_VALUE(incremental_grid_update_,
+                          "performance.incremental_grid_update");
+  BDM_ASSIGN_CONFIG_VALUE(sorted_cell_list_, "performance.sorted_cell_list");
+  BDM_ASSIGN_CONFIG_VALUE(grid_box_length_, "performance.grid_box_length");
+  BDM_ASSIGN_CONFIG_VALUE(grid_search_radius_,
+                          "performance.grid_search_radius");
+  BDM_ASSIGN_CONFIG_VALUE(verlet_skin_, "performance.verlet_skin");
+  BDM_ASSIGN_CONFIG_VALUE(symmetric_displacement_,
+                          "performance.symmetric_displacement");
+  BDM_ASSIGN_CONFIG_VALUE(box_coloring_, "performance.box_coloring");
+  BDM_ASSIGN_CONFIG_VALUE(fuse_diffusion_grids_,
+                          "performance.fuse_diffusion_grids");
+  BDM_ASSIGN_CONFIG_VALUE(sparse_diffusion_, "performance.sparse_diffusion");
+  BDM_ASSIGN_CONFIG_VALUE(sparse_diffusion_threshold_,
+                          "performance.sparse_diffusion_threshold");
 
   // development group
   BDM_ASSIGN_CONFIG_VALUE(statistics_, "development.statistics");
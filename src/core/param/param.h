@@ -151,6 +151,18 @@ struct Param {
   ///     max_bound = 100
   double max_bound_ = 100;
 
+  /// Use periodic (toroidal) boundary conditions if the simulation space is
+  /// bound (@see `bound_space_`). Simulation objects that leave the cube on
+  /// one side reenter on the opposite side and interact with neighbors
+  /// across the boundary (minimum image convention).
+  /// Currently only supports spherical simulation objects.\n
+  /// Default value: `false` (simulation objects are clamped to the bounds)\n
+  /// TOML config file:
+  ///
+  ///     [simulation]
+  ///     periodic_boundary = false
+  bool periodic_boundary_ = false;
+
   /// Allow substances to leak out of the simulation space. In this way
   /// the substance concentration will not be blocked by an artificial border\n
   /// Default value: `true`\n
@@ -167,6 +179,35 @@ struct Param {
   ///     calculate_gradients = true
   bool calculate_gradients_ = true;
 
+  /// Numerical method used to solve the diffusion equation of the
+  /// substances {"euler", "adi"}.\n
+  /// The explicit Euler method is only stable if
+  /// `D * dt / box_length^2 < 1/6`. The alternating-direction implicit
+  /// method (ADI) is unconditionally stable, which allows fine diffusion
+  /// grids without reducing the time step.
+  /// Can be changed for single substances with
+  /// `DiffusionGrid::SetDiffusionMethod`.\n
+  /// Default value: `"euler"`\n
+  /// TOML config file:
+  ///
+  ///     [simulation]
+  ///     diffusion_method = "euler"
+  std::string diffusion_method_ = "euler";
+
+  /// Number of diffusion steps per simulation step. Each diffusion step
+  /// covers `1 / diffusion_substeps_` of the time step of the grid
+  /// (`DiffusionGrid::SetTimeStep`), which also relaxes the stability limit
+  /// of the explicit Euler method by this factor.
+  /// Consecutive Euler steps are performed with temporal blocking
+  /// (see `DiffusionGrid::DiffuseEulerTimeBlocked`).
+  /// Must be at least `1`.\n
+  /// Default value: `1`\n
+  /// TOML config file:
+  ///
+  ///     [simulation]
+  ///     diffusion_substeps = 1
+  uint64_t diffusion_substeps_ = 1;
+
   // visualization values ------------------------------------------------------
 
   /// Use ParaView Catalyst for live visualization.\n
@@ -268,6 +309,18 @@ struct Param {
   ///     scheduling_batch_size = 1000
   uint64_t scheduling_batch_size_ = 1000;
 
+  /// Number of iterations between two calls to
+  /// `ResourceManager::SortAndBalanceNumaNodes`. Sorting simulation objects
+  /// along the Z-order curve restores the memory locality of neighboring
+  /// simulation objects, which decays as they move, divide and die.\n
+  /// `0` disables automatic sorting.\n
+  /// Default value: `0`\n
+  /// TOML config file:
+  ///
+  ///     [performance]
+  ///     so_sort_frequency = 0
+  uint64_t so_sort_frequency_ = 0;
+
   /// Calculation of the displacement (mechanical interaction) is an
   /// expensive operation. If simulation objects do not move or grow,
   /// displacement calculation is ommited if detect_static_sim_objects is turned
@@ -291,6 +344,123 @@ struct Param {
   ///     cache_neighbors = false
   bool cache_neighbors_ = false;
 
+  /// Update the neighbor grid incrementally. Only simulation objects that
+  /// changed their box since the last update are relinked. The grid is fully
+  /// rebuilt if it has to grow, i.e. if a simulation object left the current
+  /// grid dimensions or became larger than the box length.\n
+  /// Default value: `false`\n
+  /// TOML config file:
+  ///
+  ///     [performance]
+  ///     incremental_grid_update = false
+  bool incremental_grid_update_ = false;
+
+  /// Store pointers to the simulation objects sorted by their grid box in one
+  /// contiguous array after each grid update. Neighbor searches then read
+  /// sequential memory instead of following a linked list. They return the
+  /// same neighbors and distances as without this option.\n
+  /// Default value: `false`\n
+  /// TOML config file:
+  ///
+  ///     [performance]
+  ///     sorted_cell_list = false
+  bool sorted_cell_list_ = false;
+
+  /// Length of a box in the neighbor grid. If set to `0`, the box length
+  /// is determined by the largest simulation object.
+  /// Smaller boxes reduce the number of neighbor candidates if the sizes of
+  /// simulation objects differ a lot. The grid then searches multiple layers
+  /// of boxes to cover the search radius.\n
+  /// Default value: `0`\n
+  /// TOML config file:
+  ///
+  ///     [performance]
+  ///     grid_box_length = 0
+  uint32_t grid_box_length_ = 0;
+
+  /// Minimum radius that neighbor searches of the grid have to cover. The
+  /// actual search radius is the maximum of this value and the size of the
+  /// largest simulation object.\n
+  /// Default value: `0`\n
+  /// TOML config file:
+  ///
+  ///     [performance]
+  ///     grid_search_radius = 0
+  double grid_search_radius_ = 0;
+
+  /// Skin distance of the Verlet list. If larger than zero, the grid stores
+  /// the neighbors of each simulation object within the search radius plus
+  /// this skin (see `VerletList`). Subsequent grid updates and neighbor
+  /// searches are skipped until a simulation object moved more than half
+  /// the skin, grew larger than the search radius, or simulation objects
+  /// were added or removed.
+  /// Neighbor queries are answered from the list while it is valid.\n
+  /// Default value: `0` (Verlet list is disabled)\n
+  /// TOML config file:
+  ///
+  ///     [performance]
+  ///     verlet_skin = 0
+  double verlet_skin_ = 0;
+
+  /// Calculate the mechanical force between two neighboring cells only once
+  /// and apply it to both of them (see `DisplacementOpSymmetric`).
+  /// Forces are calculated after all other operations of an iteration, for
+  /// the positions at that time. Currently only supports `Cell`s.\n
+  /// Default value: `false`\n
+  /// TOML config file:
+  ///
+  ///     [performance]
+  ///     symmetric_displacement = false
+  bool symmetric_displacement_ = false;
+
+  /// Ensure that simulation objects can safely modify their neighbors by
+  /// processing grid boxes in independent color classes instead of acquiring
+  /// a `NeighborMutex` for each simulation object
+  /// (see `Grid::ApplyOnAllElementsByBoxColor`).
+  /// The operations of neighboring simulation objects are never executed
+  /// at the same time.\n
+  /// Default value: `false`\n
+  /// TOML config file:
+  ///
+  ///     [performance]
+  ///     box_coloring = false
+  bool box_coloring_ = false;
+
+  /// Diffuse all substances whose diffusion grids have the same number of
+  /// boxes in one sweep over the simulation space and calculate their
+  /// gradients in the same sweep
+  /// (see `DiffusionGrid::DiffuseAndCalculateGradients`).
+  /// Replaces one parallel region and memory pass per substance and
+  /// function with a single one.\n
+  /// Default value: `false`\n
+  /// TOML config file:
+  ///
+  ///     [performance]
+  ///     fuse_diffusion_grids = false
+  bool fuse_diffusion_grids_ = false;
+
+  /// Divide the diffusion grids into bricks of 8^3 boxes and only update
+  /// bricks with non-negligible concentration and their neighbors
+  /// (see `DiffusionGrid::SetSparse`). Speeds up the explicit Euler method
+  /// if the substances only cover a small part of the simulation space.
+  /// Memory consumption is not reduced.\n
+  /// Default value: `false`\n
+  /// TOML config file:
+  ///
+  ///     [performance]
+  ///     sparse_diffusion = false
+  bool sparse_diffusion_ = false;
+
+  /// If `sparse_diffusion_` is enabled, bricks whose concentrations are all
+  /// below or equal to this value are set to zero. The default value
+  /// does not change the results.\n
+  /// Default value: `0`\n
+  /// TOML config file:
+  ///
+  ///     [performance]
+  ///     sparse_diffusion_threshold = 0
+  double sparse_diffusion_threshold_ = 0;
+
   // development values --------------------------------------------------------
   /// Statistics of profiling data; keeps track of the execution time of each
   /// operation at every timestep.\n
@@ -19,120 +19,85 @@ namespace bdm {
 
 void ResourceManager::ApplyOnAllElementsParallel(
     const std::function<void(SimObject*)>& function) {
-#pragma omp parallel
-  {
-    auto tid = omp_get_thread_num();
-    auto nid = thread_info_->GetNumaNode(tid);
-    auto threads_in_numa = thread_info_->GetThreadsInNumaNode(nid);
-    auto& numa_sos = sim_objects_[nid];
-    assert(thread_info_->GetNumaNode(tid) == numa_node_of_cpu(sched_getcpu()));
-
-    // use static scheduling for now
-    auto correction = numa_sos.size() % threads_in_numa == 0 ? 0 : 1;
-    auto chunk = numa_sos.size() / threads_in_numa + correction;
-    auto start = thread_info_->GetNumaThreadId(tid) * chunk;
-    auto end = std::min(numa_sos.size(), start + chunk);
-
-    for (uint64_t i = start; i < end; ++i) {
-      function(numa_sos[i]);
-    }
-  }
+  ApplyOnAllElementsParallel<std::function<void(SimObject*)>>(function);
 }
 
 void ResourceManager::ApplyOnAllElementsParallelDynamic(
     uint64_t chunk, const std::function<void(SimObject*, SoHandle)>& function) {
-  // adapt chunk size
-  auto num_so = GetNumSimObjects();
-  uint64_t factor = (num_so / thread_info_->GetMaxThreads()) / chunk;
-  chunk = (num_so / thread_info_->GetMaxThreads()) / (factor + 1);
-  chunk = chunk >= 1 ? chunk : 1;
-
-  // use dynamic scheduling
-  // Unfortunately openmp's built in functionality can't be used, since
-  // threads belong to different numa domains and thus operate on
-  // different containers
-  auto numa_nodes = thread_info_->GetNumaNodes();
-  auto max_threads = omp_get_max_threads();
-  std::vector<uint64_t> num_chunks_per_numa(numa_nodes);
-  for (int n = 0; n < numa_nodes; n++) {
-    auto correction = sim_objects_[n].size() % chunk == 0 ? 0 : 1;
-    num_chunks_per_numa[n] = sim_objects_[n].size() / chunk + correction;
-  }
+  ApplyOnAllElementsParallelDynamic<
+      std::function<void(SimObject*, SoHandle)>>(chunk, function);
+}
 
-  std::vector<std::atomic<uint64_t>*> counters(max_threads, nullptr);
-  std::vector<uint64_t> max_counters(max_threads);
-  for (int thread_cnt = 0; thread_cnt < max_threads; thread_cnt++) {
-    uint64_t current_nid = thread_info_->GetNumaNode(thread_cnt);
-
-    auto correction =
-        num_chunks_per_numa[current_nid] %
-                    thread_info_->GetThreadsInNumaNode(current_nid) ==
-                0
-            ? 0
-            : 1;
-    uint64_t num_chunks_per_thread =
-        num_chunks_per_numa[current_nid] /
-            thread_info_->GetThreadsInNumaNode(current_nid) +
-        correction;
-    auto start =
-        num_chunks_per_thread * thread_info_->GetNumaThreadId(thread_cnt);
-    auto end = std::min(num_chunks_per_numa[current_nid],
-                        start + num_chunks_per_thread);
-
-    counters[thread_cnt] = new std::atomic<uint64_t>(start);
-    max_counters[thread_cnt] = end;
+void ResourceManager::RemoveSimObjects(const std::vector<SoUid>& uids) {
+  modification_count_++;
+  // element indices of removed sim objects per numa node
+  // Removing the uid from the map right away filters duplicates.
+  std::vector<std::vector<uint64_t>> removed(sim_objects_.size());
+  for (auto uid : uids) {
+    if (!uid_soh_map_.Contains(uid)) {
+      continue;
+    }
+    auto soh = uid_soh_map_[uid];
+    uid_soh_map_.Remove(uid);
+    removed[soh.GetNumaNode()].push_back(soh.GetElementIdx());
   }
 
-#pragma omp parallel
-  {
-    auto tid = omp_get_thread_num();
-    auto nid = thread_info_->GetNumaNode(tid);
-
-    // thread private variables (compilation error with
-    // firstprivate(chunk, numa_node_) with some openmp versions clause)
-    auto p_numa_nodes = thread_info_->GetNumaNodes();
-    auto p_max_threads = omp_get_max_threads();
-    auto p_chunk = chunk;
-    assert(thread_info_->GetNumaNode(tid) == numa_node_of_cpu(sched_getcpu()));
-
-    // dynamic scheduling
-    uint64_t start = 0;
-    uint64_t end = 0;
-
-    // this loop implements work stealing from other NUMA nodes if there
-    // are imbalances. Each thread starts with its NUMA domain. Once, it
-    // is finished the thread looks for tasks on other domains
-    for (int n = 0; n < p_numa_nodes; n++) {
-      int current_nid = (nid + n) % p_numa_nodes;
-      for (int thread_cnt = 0; thread_cnt < p_max_threads; thread_cnt++) {
-        uint64_t current_tid = (tid + thread_cnt) % p_max_threads;
-        if (current_nid != thread_info_->GetNumaNode(current_tid)) {
-          continue;
-        }
+  for (uint64_t n = 0; n < sim_objects_.size(); n++) {
+    auto& numa_sos = sim_objects_[n];
+    auto& indices = removed[n];
+    if (indices.empty()) {
+      continue;
+    }
+    auto num_removed = indices.size();
+    auto new_size = numa_sos.size() - num_removed;
+
+    // Removed elements in front of new_size leave a hole that is filled with
+    // a remaining element from the tail [new_size, size). Both sets have the
+    // same number of elements.
+    std::vector<char> tail_removed(num_removed, 0);
+    std::vector<uint64_t> holes;
+    for (auto idx : indices) {
+      if (idx >= new_size) {
+        tail_removed[idx - new_size] = 1;
+      } else {
+        holes.push_back(idx);
+      }
+    }
+    std::vector<uint64_t> remaining;
+    remaining.reserve(holes.size());
+    for (uint64_t i = 0; i < num_removed; i++) {
+      if (!tail_removed[i]) {
+        remaining.push_back(new_size + i);
+      }
+    }
 
-        auto& numa_sos = sim_objects_[current_nid];
-        uint64_t old_count = (*(counters[current_tid]))++;
-        while (old_count < max_counters[current_tid]) {
-          start = old_count * p_chunk;
-          end =
-              std::min(static_cast<uint64_t>(numa_sos.size()), start + p_chunk);
+#pragma omp parallel for
+    for (uint64_t i = 0; i < holes.size(); i++) {
+      auto hole = holes[i];
+      delete numa_sos[hole];
+      auto* so = numa_sos[remaining[i]];
+      numa_sos[hole] = so;
+      uid_soh_map_.Insert(so->GetUid(), SoHandle(n, hole));
+    }
 
-          for (uint64_t i = start; i < end; ++i) {
-            function(numa_sos[i], SoHandle(current_nid, i));
-          }
+#pragma omp parallel for
+    for (uint64_t i = 0; i < num_removed; i++) {
+      if (tail_removed[i]) {
+        delete numa_sos[new_size + i];
+      }
+    }
 
-          old_count = (*(counters[current_tid]))++;
-        }
-      }  // work stealing loop numa_nodes_
-    }    // work stealing loop  threads
+    numa_sos.resize(new_size);
   }
 
-  for (auto* counter : counters) {
-    delete counter;
+  // release the entries of removed uids if they dominate the uid map
+  if (uid_soh_map_.capacity() > 2 * GetNumSimObjects()) {
+    uid_soh_map_.Compact(SoUidGenerator::Get()->GetLastId());
   }
 }
 
 void ResourceManager::SortAndBalanceNumaNodes() {
+  modification_count_++;
   // balance simulation objects per numa node according to the number of
   // threads associated with each numa domain
   auto numa_nodes = thread_info_->GetNumaNodes();
@@ -202,8 +167,9 @@ void ResourceManager::SortAndBalanceNumaNodes() {
       if (nid == n) {
         auto threads_in_numa = thread_info_->GetThreadsInNumaNode(nid);
         auto& sohandles = sorted_so_handles[n];
-        assert(thread_info_->GetNumaNode(tid) ==
-               numa_node_of_cpu(sched_getcpu()));
+        assert(!thread_info_->ThreadsArePinned() ||
+               thread_info_->GetNumaNode(tid) ==
+                   numa_node_of_cpu(sched_getcpu()));
 
         // use static scheduling
         auto correction = sohandles.size() % threads_in_numa == 0 ? 0 : 1;
@@ -211,11 +177,18 @@ void ResourceManager::SortAndBalanceNumaNodes() {
         auto start = thread_info_->GetNumaThreadId(tid) * chunk;
         auto end = std::min(sohandles.size(), start + chunk);
 
+        // Only simulation objects that change their numa node are copied,
+        // to move their memory to the new numa node (see `MemoryManager`).
+        // All others are reordered without touching them.
         for (uint64_t e = start; e < end; e++) {
           auto& handle = sohandles[e];
           auto* so = sim_objects_[handle.GetNumaNode()][handle.GetElementIdx()];
-          dest[e] = so->GetCopy();
-          delete so;
+          if (handle.GetNumaNode() == n) {
+            dest[e] = so;
+          } else {
+            dest[e] = so->GetCopy();
+            delete so;
+          }
         }
       }
     }
@@ -226,8 +199,8 @@ void ResourceManager::SortAndBalanceNumaNodes() {
   }
 
   // update uid_soh_map_
-  ApplyOnAllElements([this](SimObject* so, SoHandle soh) {
-    this->uid_soh_map_[so->GetUid()] = soh;
+  ApplyOnAllElementsParallelDynamic(1000, [this](SimObject* so, SoHandle soh) {
+    this->uid_soh_map_.Insert(so->GetUid(), soh);
   });
 
   if (Simulation::GetActive()->GetParam()->debug_numa_) {
@@ -19,7 +19,9 @@
 #include <sched.h>
 #include <tbb/concurrent_unordered_map.h>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <ostream>
@@ -37,6 +39,7 @@
 #endif
 #endif
 
+#include "core/container/so_uid_map.h"
 #include "core/diffusion_grid.h"
 #include "core/sim_object/sim_object.h"
 #include "core/sim_object/so_uid.h"
@@ -120,6 +123,7 @@ class ResourceManager {
                  "Call to numa_available failed with return code: ", ret);
     }
     sim_objects_.resize(numa_num_configured_nodes());
+    uid_soh_map_.clear(SoUidGenerator::Get()->GetLastId());
   }
 
   virtual ~ResourceManager() {
@@ -148,6 +152,7 @@ class ResourceManager {
     }
     sim_objects_ = std::move(other.sim_objects_);
     diffusion_grids_ = std::move(other.diffusion_grids_);
+    modification_count_++;
 
     RestoreUidSoMap();
     return *this;
@@ -155,21 +160,30 @@ class ResourceManager {
 
   void RestoreUidSoMap() {
     // rebuild uid_soh_map_
-    uid_soh_map_.clear();
+    // only allocate entries for the range of uids that is actually used
+    auto first_uid = SoUidGenerator::Get()->GetLastId();
+    SoUid end_uid = 0;
+    for (auto& numa_sos : sim_objects_) {
+      for (auto* so : numa_sos) {
+        first_uid = std::min(first_uid, so->GetUid());
+        end_uid = std::max(end_uid, so->GetUid() + 1);
+      }
+    }
+    uid_soh_map_.clear(first_uid);
+    uid_soh_map_.resize(end_uid);
     for (unsigned n = 0; n < sim_objects_.size(); ++n) {
       for (unsigned i = 0; i < sim_objects_[n].size(); ++i) {
         auto* so = sim_objects_[n][i];
-        this->uid_soh_map_[so->GetUid()] = SoHandle(n, i);
+        this->uid_soh_map_.Insert(so->GetUid(), SoHandle(n, i));
       }
     }
   }
 
   SimObject* GetSimObject(SoUid uid) {
-    auto search_it = uid_soh_map_.find(uid);
-    if (search_it == uid_soh_map_.end()) {
+    if (!uid_soh_map_.Contains(uid)) {
       return nullptr;
     }
-    SoHandle soh = search_it->second;
+    SoHandle soh = uid_soh_map_[uid];
     return sim_objects_[soh.GetNumaNode()][soh.GetElementIdx()];
   }
 
@@ -177,7 +191,9 @@ class ResourceManager {
     return sim_objects_[soh.GetNumaNode()][soh.GetElementIdx()];
   }
 
-  SoHandle GetSoHandle(SoUid uid) { return uid_soh_map_[uid]; }
+  /// Returns the SoHandle of the given uid, or an invalid SoHandle if the uid
+  /// is not stored in this ResourceManager.
+  SoHandle GetSoHandle(SoUid uid) const { return uid_soh_map_.Get(uid); }
 
   void AddDiffusionGrid(DiffusionGrid* dgrid) {
     uint64_t substance_id = dgrid->GetSubstanceId();
@@ -276,18 +292,177 @@ class ResourceManager {
 
   /// Apply a function on all elements.\n
   /// Function invocations are parallelized.\n
-  /// Uses static scheduling.
+  /// Uses static scheduling.\n
+  /// `function` is called with `(SimObject*)`. Since it is a template
+  /// parameter, calls can be inlined.
   /// \see ApplyOnAllElements
+  template <typename TFunctor>
+  void ApplyOnAllElementsParallel(const TFunctor& function) {
+#pragma omp parallel
+    {
+      auto tid = omp_get_thread_num();
+      auto nid = thread_info_->GetNumaNode(tid);
+      auto threads_in_numa = thread_info_->GetThreadsInNumaNode(nid);
+      auto& numa_sos = sim_objects_[nid];
+      assert(!thread_info_->ThreadsArePinned() ||
+             thread_info_->GetNumaNode(tid) ==
+                 numa_node_of_cpu(sched_getcpu()));
+
+      // use static scheduling for now
+      auto correction = numa_sos.size() % threads_in_numa == 0 ? 0 : 1;
+      auto chunk = numa_sos.size() / threads_in_numa + correction;
+      auto start = thread_info_->GetNumaThreadId(tid) * chunk;
+      auto end = std::min(numa_sos.size(), start + chunk);
+
+      for (uint64_t i = start; i < end; ++i) {
+        function(numa_sos[i]);
+      }
+    }
+  }
+
   void ApplyOnAllElementsParallel(
       const std::function<void(SimObject*)>& function);
 
   /// Apply a function on all elements.\n
   /// Function invocations are parallelized.\n
   /// Uses dynamic scheduling and work stealing. Batch size controlled by
-  /// `chunk`.
+  /// `chunk`.\n
+  /// Each thread starts with a contiguous range of chunks of its NUMA
+  /// domain. Once it has finished its own range, it steals half of the
+  /// remaining chunks of another thread. Threads of the same NUMA domain are
+  /// preferred as victims. If threads had to wait long for the last chunks
+  /// in the previous call from the same call site (i.e. the costs per
+  /// simulation object were imbalanced), the chunk size is reduced;
+  /// otherwise, it is increased again up to `chunk`. Each lambda type has its
+  /// own tuning state; all calls through the `std::function` overload share
+  /// one. Concurrent calls are safe.\n
+  /// `function` is called with `(SimObject*, SoHandle)`. Since it is a
+  /// template parameter, calls can be inlined.
   /// \param chunk number of sim objects that are assigned to a thread (batch
   /// size)
   /// \see ApplyOnAllElements
+  template <typename TFunctor>
+  void ApplyOnAllElementsParallelDynamic(uint64_t chunk,
+                                         const TFunctor& function) {
+    auto max_threads = omp_get_max_threads();
+    auto numa_nodes = thread_info_->GetNumaNodes();
+
+    // adapt chunk size
+    // Chunk sizes are divided by this factor. It is adapted after each call
+    // based on the load imbalance. Each lambda has its own type and thus its
+    // own instantiation of this static variable.
+    static std::atomic<uint64_t> chunk_divisor{1};
+    const uint64_t divisor = chunk_divisor.load(std::memory_order_relaxed);
+    auto num_so = GetNumSimObjects();
+    uint64_t factor = (num_so / max_threads) / chunk;
+    chunk = (num_so / max_threads) / (factor + 1);
+    chunk /= divisor;
+    chunk = chunk >= 1 ? chunk : 1;
+
+    // chunks of all numa nodes are numbered consecutively
+    // chunk_offsets[n] is the id of the first chunk of numa node n
+    std::vector<uint64_t> chunk_offsets(numa_nodes + 1);
+    for (int n = 0; n < numa_nodes; n++) {
+      auto correction = sim_objects_[n].size() % chunk == 0 ? 0 : 1;
+      chunk_offsets[n + 1] =
+          chunk_offsets[n] + sim_objects_[n].size() / chunk + correction;
+    }
+
+    // initial partitioning: the chunks of a numa node are distributed
+    // evenly among its threads
+    std::vector<ChunkRange> ranges(max_threads);
+    for (int thread_cnt = 0; thread_cnt < max_threads; thread_cnt++) {
+      auto nid = thread_info_->GetNumaNode(thread_cnt);
+      auto threads_in_numa = thread_info_->GetThreadsInNumaNode(nid);
+      auto num_chunks = chunk_offsets[nid + 1] - chunk_offsets[nid];
+      auto correction = num_chunks % threads_in_numa == 0 ? 0 : 1;
+      uint64_t num_chunks_per_thread =
+          num_chunks / threads_in_numa + correction;
+      auto start = std::min(
+          num_chunks,
+          num_chunks_per_thread * thread_info_->GetNumaThreadId(thread_cnt));
+      auto end = std::min(num_chunks, start + num_chunks_per_thread);
+      ranges[thread_cnt].Set(chunk_offsets[nid] + start,
+                             chunk_offsets[nid] + end);
+    }
+
+    std::vector<double> finish_times(max_threads);
+    auto start_time = omp_get_wtime();
+
+#pragma omp parallel
+    {
+      auto tid = omp_get_thread_num();
+      auto nid = thread_info_->GetNumaNode(tid);
+
+      // thread private variables (compilation error with
+      // firstprivate(chunk, numa_node_) with some openmp versions clause)
+      auto p_numa_nodes = thread_info_->GetNumaNodes();
+      auto p_max_threads = omp_get_max_threads();
+      auto p_chunk = chunk;
+
+      auto process = [&](uint64_t chunk_id) {
+        uint16_t current_nid = 0;
+        while (chunk_id >= chunk_offsets[current_nid + 1]) {
+          current_nid++;
+        }
+        auto& numa_sos = sim_objects_[current_nid];
+        uint64_t start = (chunk_id - chunk_offsets[current_nid]) * p_chunk;
+        uint64_t end =
+            std::min(static_cast<uint64_t>(numa_sos.size()), start + p_chunk);
+        for (uint64_t i = start; i < end; ++i) {
+          function(numa_sos[i], SoHandle(current_nid, i));
+        }
+      };
+
+      auto& own = ranges[tid];
+      uint64_t chunk_id = 0;
+      uint64_t steal_begin = 0;
+      uint64_t steal_end = 0;
+      bool stolen = true;
+      while (stolen) {
+        while (own.PopFront(&chunk_id)) {
+          process(chunk_id);
+        }
+
+        // work stealing: victims in the same NUMA domain are tried first
+        stolen = false;
+        for (int n = 0; n < p_numa_nodes && !stolen; n++) {
+          int current_nid = (nid + n) % p_numa_nodes;
+          for (int thread_cnt = 1; thread_cnt < p_max_threads; thread_cnt++) {
+            uint64_t victim = (tid + thread_cnt) % p_max_threads;
+            if (current_nid != thread_info_->GetNumaNode(victim)) {
+              continue;
+            }
+            if (ranges[victim].StealHalf(&steal_begin, &steal_end)) {
+              // make the stolen chunks available to other thieves
+              own.Set(steal_begin + 1, steal_end);
+              process(steal_begin);
+              stolen = true;
+              break;
+            }
+          }
+        }
+      }
+      finish_times[tid] = omp_get_wtime();
+    }
+
+    // cost feedback for the next call: threads that run out of work have to
+    // wait until the last chunk of the slowest thread has been processed.
+    // If this tail is long compared to the whole loop, the chunks are too
+    // coarse for the costs of the simulation objects.
+    auto minmax =
+        std::minmax_element(finish_times.begin(), finish_times.end());
+    auto total = *minmax.second - start_time;
+    auto tail = *minmax.second - *minmax.first;
+    if (tail > 0.1 * total) {
+      chunk_divisor.store(std::min<uint64_t>(divisor * 2, 64),
+                          std::memory_order_relaxed);
+    } else if (tail < 0.02 * total) {
+      chunk_divisor.store(std::max<uint64_t>(divisor / 2, 1),
+                          std::memory_order_relaxed);
+    }
+  }
+
   void ApplyOnAllElementsParallelDynamic(
       uint64_t chunk,
       const std::function<void(SimObject*, SoHandle)>& function);
@@ -302,11 +477,16 @@ class ResourceManager {
 
   /// Resize `sim_objects_[numa_node]` such that it holds `current + additional`
   /// elements after this call.
+  /// Also grows the uid map, such that it can hold all uids that have been
+  /// generated so far. Therefore, the new simulation objects must have been
+  /// constructed before this call.
   /// Returns the size after
   uint64_t GrowSoContainer(size_t additional, size_t numa_node) {
+    uid_soh_map_.resize(SoUidGenerator::Get()->GetLastId());
     if (additional == 0) {
       return sim_objects_[numa_node].size();
     }
+    modification_count_++;
     auto current = sim_objects_[numa_node].size();
     sim_objects_[numa_node].resize(current + additional);
     return current;
@@ -315,7 +495,7 @@ class ResourceManager {
   /// Returns true if a sim object with the given uid is stored in this
   /// ResourceManager.
   bool Contains(SoUid uid) const {
-    return uid_soh_map_.find(uid) != uid_soh_map_.end();
+    return uid_soh_map_.Contains(uid);
   }
 
   /// Remove all simulation objects
@@ -323,7 +503,8 @@ class ResourceManager {
   /// sim_object references pointing into the ResourceManager. SoPointer are
   /// not affected.
   void Clear() {
-    uid_soh_map_.clear();
+    modification_count_++;
+    uid_soh_map_.clear(SoUidGenerator::Get()->GetLastId());
     for (auto& numa_sos : sim_objects_) {
       for (auto* so : numa_sos) {
         delete so;
@@ -332,8 +513,15 @@ class ResourceManager {
     }
   }
 
+  /// Returns a number that changes whenever simulation objects are added,
+  /// removed or reordered, i.e. whenever `SoHandle`s might have changed.
+  uint64_t GetModificationCount() const { return modification_count_; }
+
   /// Reorder simulation objects such that, sim objects are distributed to NUMA
-  /// nodes. Nearby sim objects will be moved to the same NUMA node.
+  /// nodes. Nearby sim objects will be moved to the same NUMA node.\n
+  /// Requires an up-to-date grid. Invalidates all `SoHandle`s; the grid must
+  /// be updated afterwards.
+  /// \see `Param::so_sort_frequency_`
   void SortAndBalanceNumaNodes();
 
   void DebugNuma() const;
@@ -343,37 +531,60 @@ class ResourceManager {
   /// not affected.
   void push_back(SimObject* so,  // NOLINT
                  typename SoHandle::NumaNode_t numa_node = 0) {
-    sim_objects_[numa_node].push_back(so);
-    uid_soh_map_[so->GetUid()] =
-        SoHandle(numa_node, sim_objects_[numa_node].size() - 1);
+    auto uid = so->GetUid();
+    auto& numa_sos = sim_objects_[numa_node];
+    numa_sos.push_back(so);
+    modification_count_++;
+    // `so` might have been constructed before the map was (re)started
+    uid_soh_map_.ReserveFrom(uid);
+    if (uid >= uid_soh_map_.size()) {
+      auto last_id = SoUidGenerator::Get()->GetLastId();
+      uid_soh_map_.resize(std::max(uid + 1, last_id));
+    }
+    uid_soh_map_.Insert(uid, SoHandle(numa_node, numa_sos.size() - 1));
   }
 
   /// Adds `new_sim_objects` to `sim_objects_[numa_node]`. `offset` specifies
   /// the index at which the first element is inserted. Sim objects are inserted
-  /// consecutively. This methos is thread safe only if insertion intervals do
-  /// not overlap!
+  /// consecutively. The container must have been grown beforehand
+  /// (see `GrowSoContainer`). This methos is thread safe only if insertion
+  /// intervals do not overlap!
   virtual void AddNewSimObjects(
       typename SoHandle::NumaNode_t numa_node, uint64_t offset,
       const tbb::concurrent_unordered_map<SoUid, SimObject*>& new_sim_objects) {
     uint64_t i = 0;
     for (auto& pair : new_sim_objects) {
       auto uid = pair.first;
-      uid_soh_map_[uid] = SoHandle(numa_node, offset + i);
+      uid_soh_map_.Insert(uid, SoHandle(numa_node, offset + i));
       sim_objects_[numa_node][offset + i] = pair.second;
       i++;
     }
   }
 
+  /// Adds `sim_objects` to `sim_objects_[numa_node]`. `offset` specifies the
+  /// index at which the first element is inserted. The container must have
+  /// been grown beforehand (see `GrowSoContainer`). This method is thread
+  /// safe only if insertion intervals do not overlap!
+  void AddSimObjects(typename SoHandle::NumaNode_t numa_node, uint64_t offset,
+                     const std::vector<SimObject*>& sim_objects) {
+    auto& numa_sos = sim_objects_[numa_node];
+    for (uint64_t i = 0; i < sim_objects.size(); i++) {
+      auto* so = sim_objects[i];
+      numa_sos[offset + i] = so;
+      uid_soh_map_.Insert(so->GetUid(), SoHandle(numa_node, offset + i));
+    }
+  }
+
   /// Removes the simulation object with the given uid.\n
   /// NB: This method is not thread-safe! This function invalidates
   /// sim_object references pointing into the ResourceManager. SoPointer are
   /// not affected.
   void Remove(SoUid uid) {
     // remove from map
-    auto it = uid_soh_map_.find(uid);
-    if (it != uid_soh_map_.end()) {
-      SoHandle soh = it->second;
-      uid_soh_map_.unsafe_erase(it);
+    if (uid_soh_map_.Contains(uid)) {
+      modification_count_++;
+      SoHandle soh = uid_soh_map_[uid];
+      uid_soh_map_.Remove(uid);
       // remove from vector
       auto& numa_sos = sim_objects_[soh.GetNumaNode()];
       if (soh.GetElementIdx() == numa_sos.size() - 1) {
@@ -385,11 +596,22 @@ class ResourceManager {
         auto* reordered = numa_sos.back();
         numa_sos[soh.GetElementIdx()] = reordered;
         numa_sos.pop_back();
-        uid_soh_map_[reordered->GetUid()] = soh;
+        uid_soh_map_.Insert(reordered->GetUid(), soh);
       }
     }
   }
 
+  /// Removes all simulation objects with the given uids at once.
+  /// Uids that are not stored in this ResourceManager and duplicates are
+  /// ignored.\n
+  /// Removed elements are replaced with the remaining elements from the end
+  /// of each numa container. Deletion, compaction and the update of the uid
+  /// map are performed in parallel.\n
+  /// NB: This method is not thread-safe! This function invalidates
+  /// sim_object references pointing into the ResourceManager. SoPointer are
+  /// not affected.
+  void RemoveSimObjects(const std::vector<SoUid>& uids);
+
  protected:
 #ifdef USE_OPENCL
   cl::Context* GetOpenCLContext() { return &opencl_context_; }
@@ -399,7 +621,9 @@ class ResourceManager {
 #endif
 
   /// Maps an SoUid to its storage location in `sim_objects_` \n
-  tbb::concurrent_unordered_map<SoUid, SoHandle> uid_soh_map_;  //!
+  /// Only covers the uids of this ResourceManager (see `SoUidMap`). Entries of
+  /// removed uids are released in `RemoveSimObjects`.
+  SoUidMap<SoHandle> uid_soh_map_;  //!
   ///
   std::vector<std::vector<SimObject*>> sim_objects_;
 
@@ -407,6 +631,63 @@ class ResourceManager {
 
   ThreadInfo* thread_info_ = ThreadInfo::GetInstance();  //!
 
+  /// \see `GetModificationCount`
+  uint64_t modification_count_ = 0;  //!
+
+  /// Chunks of one thread in `ApplyOnAllElementsParallelDynamic` that have
+  /// not been processed yet: [begin, end). Both bounds are stored in one
+  /// atomic (32 bit each). Hence, the owner can take chunks from the front
+  /// and other threads can steal from the back without locks.
+  /// Padded to avoid false sharing; assumes 64 byte cache lines.
+  struct ChunkRange {
+    std::atomic<uint64_t> range_;
+    char padding_[64 - sizeof(std::atomic<uint64_t>)];
+
+    static uint64_t Pack(uint64_t begin, uint64_t end) {
+      return (end << 32) | begin;
+    }
+
+    /// Must only be called by the owner while the range is empty, or before
+    /// other threads start to steal.
+    void Set(uint64_t begin, uint64_t end) { range_ = Pack(begin, end); }
+
+    /// Removes the first chunk. Returns false if the range is empty.
+    bool PopFront(uint64_t* chunk_id) {
+      uint64_t old = range_;
+      uint64_t begin;
+      uint64_t end;
+      do {
+        begin = old & 0xFFFFFFFF;
+        end = old >> 32;
+        if (begin >= end) {
+          return false;
+        }
+      } while (!range_.compare_exchange_weak(old, Pack(begin + 1, end)));
+      *chunk_id = begin;
+      return true;
+    }
+
+    /// Removes the second half of the remaining chunks. Returns false if
+    /// the range is empty.
+    bool StealHalf(uint64_t* stolen_begin, uint64_t* stolen_end) {
+      uint64_t old = range_;
+      uint64_t begin;
+      uint64_t end;
+      uint64_t half;
+      do {
+        begin = old & 0xFFFFFFFF;
+        end = old >> 32;
+        if (begin >= end) {
+          return false;
+        }
+        half = (end - begin + 1) / 2;
+      } while (!range_.compare_exchange_weak(old, Pack(begin, end - half)));
+      *stolen_begin = end - half;
+      *stolen_end = end;
+      return true;
+    }
+  };
+
 #ifdef USE_OPENCL
   cl::Context opencl_context_;             //!
   cl::CommandQueue opencl_command_queue_;  //!
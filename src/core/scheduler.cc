@@ -14,14 +14,19 @@
 
 #include "core/scheduler.h"
 
+#include <algorithm>
 #include <chrono>
+#include <limits>
 #include <string>
+#include <vector>
 
 #include "core/execution_context/in_place_exec_ctxt.h"
 #include "core/gpu/gpu_helper.h"
+#include "core/grid.h"
 #include "core/operation/bound_space_op.h"
 #include "core/operation/diffusion_op.h"
 #include "core/operation/displacement_op.h"
+#include "core/operation/fused_operation.h"
 #include "core/operation/op_timer.h"
 #include "core/param/param.h"
 #include "core/resource_manager.h"
@@ -32,6 +37,26 @@
 
 namespace bdm {
 
+namespace {
+
+/// Built-in function of the operation "bound space". Forwards to the
+/// instance owned by the scheduler, so that the fused and the unfused
+/// operations share its state. Its type identifies the built-in function
+/// (see `Scheduler::UseFusedOperations`).
+struct BoundSpaceFunction {
+  BoundSpace* bound_space_;
+  void operator()(SimObject* so) const { (*bound_space_)(so); }
+};
+
+/// Built-in function of the operation "displacement"
+/// \see BoundSpaceFunction
+struct DisplacementFunction {
+  DisplacementOp* displacement_;
+  void operator()(SimObject* so) const { (*displacement_)(so); }
+};
+
+}  // namespace
+
 Scheduler::Scheduler() {
   auto* param = Simulation::GetActive()->GetParam();
   backup_ = new SimulationBackup(param->backup_file_, param->restore_file_);
@@ -45,22 +70,36 @@ Scheduler::Scheduler() {
   diffusion_ = new DiffusionOp();
 
   // initialise operations_
-  auto first_op =
-      Operation("first", [](SimObject* so) { so->UpdateRunDisplacement(); });
-  auto last_op = Operation(
-      "last", [](SimObject* so) { so->ApplyRunDisplacementForAllNextTs(); });
-  auto biology_module_op = Operation(
-      "biology modules", [](SimObject* so) { so->RunBiologyModules(); });
-  auto discretization_op = Operation(
-      "discretization", [](SimObject* so) { so->RunDiscretization(); });
-
-  auto displacement_op = Operation("displacement", *displacement_);
-
-  operations_ = {first_op,          Operation("bound space", *bound_space_),
+  auto first = [](SimObject* so) { so->UpdateRunDisplacement(); };
+  auto last = [](SimObject* so) { so->ApplyRunDisplacementForAllNextTs(); };
+  auto biology_modules = [](SimObject* so) { so->RunBiologyModules(); };
+  auto discretization = [](SimObject* so) { so->RunDiscretization(); };
+
+  auto bound_space_fn = BoundSpaceFunction{bound_space_};
+  auto displacement_fn = DisplacementFunction{displacement_};
+
+  auto first_op = Operation("first", first);
+  auto last_op = Operation("last", last);
+  auto biology_module_op = Operation("biology modules", biology_modules);
+  auto discretization_op = Operation("discretization", discretization);
+
+  auto displacement_op = Operation("displacement", displacement_fn);
+
+  operations_ = {first_op,          Operation("bound space", bound_space_fn),
                  biology_module_op, displacement_op,
                  discretization_op, last_op};
   protected_operations_ = {first_op.name_, biology_module_op.name_,
                            discretization_op.name_, last_op.name_};
+
+  // initialise fused built-in operations
+  fused_first_ops_ = Operation(
+      "fused first", FuseOperations(first, bound_space_fn, biology_modules,
+                                    displacement_fn));
+  fused_first_ops_no_displacement_ =
+      Operation("fused first without displacement",
+                FuseOperations(first, bound_space_fn, biology_modules));
+  fused_last_ops_ =
+      Operation("fused last", FuseOperations(discretization, last));
 }
 
 Scheduler::~Scheduler() {
@@ -142,16 +181,50 @@ void Scheduler::Execute(bool last_iteration) {
   });
   Timing::Time("neighbors", [&]() { grid->UpdateGrid(); });
 
+  if (param->so_sort_frequency_ != 0 &&
+      total_steps_ % param->so_sort_frequency_ == 0 &&
+      rm->GetNumSimObjects() != 0) {
+    Timing::Time("sort and balance", [&]() {
+      rm->SortAndBalanceNumaNodes();
+      // all SoHandles have changed
+      grid->UpdateGrid();
+    });
+  }
+
   // update all sim objects: run all CPU operations
   const auto& scheduled_ops = GetScheduleOps();
-  rm->ApplyOnAllElementsParallelDynamic(
-      param->scheduling_batch_size_, [&](SimObject* so, SoHandle) {
-        sim->GetExecutionContext()->Execute(so, scheduled_ops);
-      });
+  auto execute = [&](SimObject* so, SoHandle) {
+    // dormant sim objects are skipped entirely
+    if (so->IsDormant() && !so->CheckWakeUp(total_steps_)) {
+      return;
+    }
+    sim->GetExecutionContext()->Execute(so, scheduled_ops);
+  };
+  if (param->box_coloring_) {
+    grid->ApplyOnAllElementsByBoxColor(execute);
+  } else {
+    UpdateActiveSimObjects();
+    if (has_dormant_sim_objects_) {
+      // only iterate over the sim objects that are awake
+      uint64_t batch_size = param->scheduling_batch_size_;
+#pragma omp parallel for schedule(dynamic, batch_size)
+      for (uint64_t i = 0; i < active_sim_objects_.size(); i++) {
+        sim->GetExecutionContext()->Execute(active_sim_objects_[i],
+                                            scheduled_ops);
+      }
+    } else {
+      rm->ApplyOnAllElementsParallelDynamic(param->scheduling_batch_size_,
+                                            execute);
+    }
+  }
 
-  // update all sim objects: hardware accelerated operations
+  // update all sim objects: hardware accelerated or symmetric operations
   if (param->run_mechanical_interactions_ && !displacement_->UseCpu()) {
-    Timing::Time("displacement (GPU/FPGA)", *displacement_);
+    if (displacement_->UseSymmetric()) {
+      Timing::Time("displacement (symmetric)", *displacement_);
+    } else {
+      Timing::Time("displacement (GPU/FPGA)", *displacement_);
+    }
   }
 
   // finish updating sim objects
@@ -207,6 +280,8 @@ void Scheduler::Initialize() {
   // commit all changes
   const auto& all_exec_ctxts = sim->GetAllExecCtxts();
   all_exec_ctxts[0]->TearDownIterationAll(all_exec_ctxts);
+  // sim objects might have been added or restored in a dormant state
+  InvalidateActiveSimObjects();
 
   if (!is_gpu_environment_initialized_ && param->use_gpu_) {
     InitializeGPUEnvironment();
@@ -216,10 +291,22 @@ void Scheduler::Initialize() {
   if (param->bound_space_) {
     rm->ApplyOnAllElementsParallel(*bound_space_);
   }
+  if (param->run_mechanical_interactions_) {
+    displacement_->CheckSimObjects();
+  }
   grid->Initialize();
   int lbound = grid->GetDimensionThresholds()[0];
   int rbound = grid->GetDimensionThresholds()[1];
+  if (param->diffusion_substeps_ < 1) {
+    Log::Fatal("Scheduler::Initialize",
+               "Param::diffusion_substeps_ must be at least 1, but is ",
+               param->diffusion_substeps_);
+  }
   rm->ApplyOnAllDiffusionGrids([&](DiffusionGrid* dgrid) {
+    dgrid->SetNumSubsteps(param->diffusion_substeps_);
+    if (param->sparse_diffusion_) {
+      dgrid->SetSparse(true, param->sparse_diffusion_threshold_);
+    }
     // Create data structures, whose size depend on the grid dimensions
     dgrid->Initialize({lbound, rbound, lbound, rbound, lbound, rbound});
     // Initialize data structures with user-defined values
@@ -227,14 +314,126 @@ void Scheduler::Initialize() {
   });
 }
 
+void Scheduler::UpdateActiveSimObjects() {
+  auto* rm = Simulation::GetActive()->GetResourceManager();
+  bool valid = active_sim_objects_valid_.exchange(true);
+  if (!has_dormant_sim_objects_ && valid) {
+    // all sim objects are awake; new sim objects are awake as well
+    rm_modification_count_ = rm->GetModificationCount();
+    return;
+  }
+
+  if (valid && rm_modification_count_ == rm->GetModificationCount() &&
+      total_steps_ < next_wake_up_step_) {
+    // only evaluate the wake conditions of biology modules
+    auto max_threads = omp_get_max_threads();
+    std::vector<std::vector<SimObject*>> woken(max_threads);
+    std::vector<std::vector<SimObject*>> dormant(max_threads);
+#pragma omp parallel for schedule(static)
+    for (uint64_t i = 0; i < polled_sim_objects_.size(); i++) {
+      auto* so = polled_sim_objects_[i];
+      auto tid = omp_get_thread_num();
+      if (so->CheckWakeUp(total_steps_)) {
+        woken[tid].push_back(so);
+      } else {
+        dormant[tid].push_back(so);
+      }
+    }
+
+    uint64_t num_woken = 0;
+    for (auto& thread_woken : woken) {
+      num_woken += thread_woken.size();
+    }
+    if (num_woken == 0) {
+      return;
+    }
+    polled_sim_objects_.clear();
+    for (int t = 0; t < max_threads; t++) {
+      active_sim_objects_.insert(active_sim_objects_.end(), woken[t].begin(),
+                                 woken[t].end());
+      polled_sim_objects_.insert(polled_sim_objects_.end(), dormant[t].begin(),
+                                 dormant[t].end());
+    }
+    return;
+  }
+
+  // rebuild
+  auto max_threads = omp_get_max_threads();
+  std::vector<std::vector<SimObject*>> active(max_threads);
+  std::vector<std::vector<SimObject*>> polled(max_threads);
+  std::vector<uint64_t> next_wake_up(max_threads,
+                                     std::numeric_limits<uint64_t>::max());
+  std::vector<uint64_t> num_dormant(max_threads);
+  rm->ApplyOnAllElementsParallel([&](SimObject* so) {
+    auto tid = omp_get_thread_num();
+    if (!so->IsDormant() || so->CheckWakeUp(total_steps_)) {
+      active[tid].push_back(so);
+      return;
+    }
+    num_dormant[tid]++;
+    next_wake_up[tid] = std::min(next_wake_up[tid], so->GetWakeUpStep());
+    if (!so->GetAllBiologyModules().empty()) {
+      polled[tid].push_back(so);
+    }
+  });
+
+  active_sim_objects_.clear();
+  polled_sim_objects_.clear();
+  next_wake_up_step_ = std::numeric_limits<uint64_t>::max();
+  uint64_t total_dormant = 0;
+  for (int t = 0; t < max_threads; t++) {
+    active_sim_objects_.insert(active_sim_objects_.end(), active[t].begin(),
+                               active[t].end());
+    polled_sim_objects_.insert(polled_sim_objects_.end(), polled[t].begin(),
+                               polled[t].end());
+    next_wake_up_step_ = std::min(next_wake_up_step_, next_wake_up[t]);
+    total_dormant += num_dormant[t];
+  }
+  has_dormant_sim_objects_ = total_dormant != 0;
+  if (!has_dormant_sim_objects_) {
+    active_sim_objects_.clear();
+  }
+  rm_modification_count_ = rm->GetModificationCount();
+}
+
+bool Scheduler::UseFusedOperations() const {
+  // operations_ = {first, bound space, biology modules, displacement,
+  //                user-defined operations..., discretization, last}
+  // "bound space" and "displacement" are not protected. Users might change
+  // their frequency or replace them (`GetOperation`); the fused operations
+  // only contain the built-in functions.
+  return operations_.size() >= 6 && operations_[1].name_ == "bound space" &&
+         operations_[1].frequency_ == 1 &&
+         operations_[1].GetFunction<BoundSpaceFunction>() != nullptr &&
+         operations_[3].name_ == "displacement" &&
+         operations_[3].frequency_ == 1 &&
+         operations_[3].GetFunction<DisplacementFunction>() != nullptr;
+}
+
 std::vector<Operation> Scheduler::GetScheduleOps() {
   std::vector<Operation> scheduled_ops;
   scheduled_ops.reserve(operations_.size());
   auto* param = Simulation::GetActive()->GetParam();
+  bool skip_displacement =
+      !param->run_mechanical_interactions_ || !displacement_->UseCpu();
+
+  if (UseFusedOperations()) {
+    scheduled_ops.push_back(skip_displacement
+                                ? fused_first_ops_no_displacement_
+                                : fused_first_ops_);
+    for (uint64_t i = 4; i < operations_.size() - 2; i++) {
+      auto& op = operations_[i];
+      if (total_steps_ % op.frequency_ == 0) {
+        scheduled_ops.push_back(op);
+      }
+    }
+    scheduled_ops.push_back(fused_last_ops_);
+    return scheduled_ops;
+  }
+
   for (auto& op : operations_) {
     // special condition for displacement
-    if (op.name_ == "displacement" &&
-        (!param->run_mechanical_interactions_ || !displacement_->UseCpu())) {
+    if (op.name_ == "displacement" && skip_displacement) {
       continue;
     }
     if (total_steps_ % op.frequency_ == 0) {
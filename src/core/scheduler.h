@@ -15,6 +15,7 @@
 #ifndef CORE_SCHEDULER_H_
 #define CORE_SCHEDULER_H_
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <set>
@@ -57,6 +58,13 @@ class Scheduler {
   /// returned.
   Operation* GetOperation(const std::string& op_name);
 
+  /// Signals that a simulation object fell asleep or woke up
+  /// (see `SimObject::Sleep`). The list of active simulation objects is
+  /// rebuilt before the next step. Thread safe.
+  void InvalidateActiveSimObjects() {
+    active_sim_objects_valid_.store(false, std::memory_order_relaxed);
+  }
+
  protected:
   uint64_t total_steps_ = 0;
 
@@ -78,6 +86,29 @@ class Scheduler {
   std::vector<Operation> operations_;  //!
   std::set<std::string> protected_operations_;
 
+  /// The built-in operations in front of and after the user-defined ones,
+  /// compiled into one kernel each (see `FusedOperation`).
+  /// `GetScheduleOps` uses them as long as the built-in operations are
+  /// present and executed every step.
+  Operation fused_first_ops_;                  //!
+  Operation fused_first_ops_no_displacement_;  //!
+  Operation fused_last_ops_;                   //!
+
+  /// Simulation objects that are awake, if at least one simulation object is
+  /// dormant (see `UpdateActiveSimObjects`)
+  std::vector<SimObject*> active_sim_objects_;  //!
+  /// Dormant simulation objects that have biology modules, whose wake
+  /// condition is evaluated in every step
+  std::vector<SimObject*> polled_sim_objects_;  //!
+  /// True if `active_sim_objects_` and `polled_sim_objects_` are in use
+  bool has_dormant_sim_objects_ = false;  //!
+  /// Smallest `SimObject::GetWakeUpStep` of all dormant simulation objects
+  uint64_t next_wake_up_step_ = 0;  //!
+  /// `ResourceManager::GetModificationCount` at the last rebuild
+  uint64_t rm_modification_count_ = 0;  //!
+  /// \see `InvalidateActiveSimObjects`
+  std::atomic<bool> active_sim_objects_valid_{false};  //!
+
   /// Backup the simulation. Backup interval based on `Param::backup_interval_`
   void Backup();
 
@@ -91,6 +122,20 @@ class Scheduler {
   // if Simulate is called with one timestep.
   void Initialize();
 
+  /// Determines the simulation objects that must be updated in this step.
+  /// The active and dormant simulation objects are only determined anew if
+  /// a simulation object fell asleep or woke up, a timed dormancy ends, or
+  /// simulation objects have been added, removed or reordered. Otherwise,
+  /// only the wake conditions of the biology modules of dormant simulation
+  /// objects are evaluated. Dormant simulation objects without biology
+  /// modules are not visited.
+  void UpdateActiveSimObjects();
+
+  /// Returns true if the built-in operations have neither been removed,
+  /// replaced nor their frequency changed, i.e. if the fused operations can
+  /// be used.
+  bool UseFusedOperations() const;
+
   // Decide which operations should be executed
   std::vector<Operation> GetScheduleOps();
 };
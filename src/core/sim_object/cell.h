@@ -29,6 +29,7 @@
 #include "core/event/cell_division_event.h"
 #include "core/event/event.h"
 #include "core/execution_context/in_place_exec_ctxt.h"
+#include "core/grid.h"
 #include "core/param/param.h"
 #include "core/shape.h"
 #include "core/sim_object/sim_object.h"
@@ -268,22 +269,6 @@ class Cell : public SimObject {
     // is not applied if the total Force is smaller than adherence.
     // Once, I should look at this more carefully.
 
-    // fixme why? copying
-    const auto& tf = GetTractorForce();
-
-    // the 3 types of movement that can occur
-    // bool biological_translation = false;
-    bool physical_translation = false;
-    // bool physical_rotation = false;
-
-    double h = dt;
-    Double3 movement_at_next_step{0, 0, 0};
-
-    // BIOLOGY :
-    // 0) Start with tractor force : What the biology defined as active
-    // movement------------
-    movement_at_next_step += tf * h;
-
     // PHYSICS
     // the physics force to move the point mass
     Double3 translation_force_on_point_mass{0, 0, 0};
@@ -299,8 +284,9 @@ class Cell : public SimObject {
     //  (We check for every neighbor object if they touch us, i.e. push us
     //  away)
 
+    DefaultForce default_force(
+        Simulation::GetActive()->GetGrid()->GetPeriodicLength());
     auto calculate_neighbor_forces = [&, this](const auto* neighbor) {
-      DefaultForce default_force;
       auto neighbor_force = default_force.GetForce(this, neighbor);
       translation_force_on_point_mass[0] += neighbor_force[0];
       translation_force_on_point_mass[1] += neighbor_force[1];
@@ -311,6 +297,29 @@ class Cell : public SimObject {
     ctxt->ForEachNeighborWithinRadius(calculate_neighbor_forces, *this,
                                       squared_radius);
 
+    return CalculateDisplacementFromForce(translation_force_on_point_mass, dt);
+  }
+
+  /// Calculates the displacement of this cell, given the sum of all forces
+  /// that its neighbors exert on it. (see `CalculateDisplacement`)
+  Double3 CalculateDisplacementFromForce(
+      const Double3& translation_force_on_point_mass, double dt) const {
+    // fixme why? copying
+    const auto& tf = GetTractorForce();
+
+    // the 3 types of movement that can occur
+    // bool biological_translation = false;
+    bool physical_translation = false;
+    // bool physical_rotation = false;
+
+    double h = dt;
+    Double3 movement_at_next_step{0, 0, 0};
+
+    // BIOLOGY :
+    // 0) Start with tractor force : What the biology defined as active
+    // movement------------
+    movement_at_next_step += tf * h;
+
     // 4) PhysicalBonds
     // How the physics influences the next displacement
     double norm_of_force = std::sqrt(translation_force_on_point_mass *
@@ -30,6 +30,7 @@
 #include "core/execution_context/in_place_exec_ctxt.h"
 #include "core/grid.h"
 #include "core/resource_manager.h"
+#include "core/scheduler.h"
 #include "core/sim_object/so_uid.h"
 #include "core/simulation.h"
 #include "core/util/log.h"
@@ -58,7 +59,9 @@ SimObject::SimObject(const SimObject& other)
       run_bm_loop_idx_(other.run_bm_loop_idx_),
       run_displacement_for_all_next_ts_(
           other.run_displacement_for_all_next_ts_),
-      run_displacement_next_ts_(other.run_displacement_next_ts_) {
+      run_displacement_next_ts_(other.run_displacement_next_ts_),
+      dormant_(other.dormant_.load(std::memory_order_relaxed)),
+      wake_up_step_(other.wake_up_step_) {
   for (auto* module : other.biology_modules_) {
     biology_modules_.push_back(module->GetCopy());
   }
@@ -87,11 +90,42 @@ void SimObject::ApplyRunDisplacementForAllNextTs() {
         double distance = this->GetDiameter() + neighbor->GetDiameter();
         if (squared_distance < distance * distance) {
           neighbor->SetRunDisplacementNextTimestep(true);
+          neighbor->WakeUp();
         }
       },
       *this);
 }
 
+void SimObject::Sleep(uint64_t steps) {
+  auto current = Simulation::GetActive()->GetScheduler()->GetSimulatedSteps();
+  // this simulation object must be skipped in the next `steps` steps
+  auto max = std::numeric_limits<uint64_t>::max();
+  wake_up_step_ = steps >= max - current ? max : current + steps + 1;
+  dormant_.store(true, std::memory_order_relaxed);
+  Simulation::GetActive()->GetScheduler()->InvalidateActiveSimObjects();
+}
+
+void SimObject::WakeUp() const {
+  if (dormant_.load(std::memory_order_relaxed)) {
+    dormant_.store(false, std::memory_order_relaxed);
+    Simulation::GetActive()->GetScheduler()->InvalidateActiveSimObjects();
+  }
+}
+
+bool SimObject::CheckWakeUp(uint64_t step) {
+  if (step >= wake_up_step_) {
+    dormant_.store(false, std::memory_order_relaxed);
+    return true;
+  }
+  for (auto* bm : biology_modules_) {
+    if (bm->WakeUp(this)) {
+      dormant_.store(false, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
 void SimObject::RunDiscretization() {}
 
 void SimObject::AssignNewUid() { uid_ = SoUidGenerator::Get()->NewSoUid(); }
@@ -16,6 +16,7 @@
 #define CORE_SIM_OBJECT_SIM_OBJECT_H_
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <limits>
 #include <memory>
@@ -27,6 +28,7 @@
 #include <vector>
 
 #include "core/container/math_array.h"
+#include "core/memory/memory_manager.h"
 #include "core/shape.h"
 #include "core/sim_object/so_pointer.h"
 #include "core/sim_object/so_uid.h"
@@ -137,6 +139,19 @@ class SimObject {
 
   virtual ~SimObject();
 
+  /// Simulation objects are allocated on the NUMA node of the calling thread
+  /// (see `MemoryManager`).
+  static void* operator new(std::size_t size) {
+    return MemoryManager::GetInstance()->New(size);
+  }
+
+  /// Placement new (e.g. used by ROOT I/O)
+  static void* operator new(std::size_t size, void* where) { return where; }
+
+  static void operator delete(void* p, std::size_t size) {
+    MemoryManager::GetInstance()->Delete(p, size);
+  }
+
   /// Executes the given function for all data members
   /// \see `SoVisitor`
   virtual void ForEachDataMember(SoVisitor* visitor) const {
@@ -202,6 +217,34 @@ class SimObject {
 
   bool RunDisplacement() const { return run_displacement_; }
 
+  /// Puts this simulation object to sleep. The scheduler skips dormant
+  /// simulation objects: no operation is executed and no neighbor mutex is
+  /// acquired. The simulation object wakes up if
+  /// (1) `steps` simulation steps have passed,
+  /// (2) `WakeUp` has been called (e.g. by a neighbor),
+  /// (3) a neighbor in contact moved (requires
+  ///     `Param::detect_static_sim_objects_`), or
+  /// (4) one of its biology modules reports that its wake condition holds
+  ///     (see `BaseBiologyModule::WakeUp`).
+  /// Dormant simulation objects are still neighbors of other simulation
+  /// objects.
+  void Sleep(uint64_t steps = std::numeric_limits<uint64_t>::max());
+
+  /// Ends the dormancy of this simulation object. Since this function is
+  /// const, it can be called for neighbors.
+  void WakeUp() const;
+
+  bool IsDormant() const { return dormant_.load(std::memory_order_relaxed); }
+
+  /// Returns the simulation step at which a dormant simulation object wakes
+  /// up at the latest
+  uint64_t GetWakeUpStep() const { return wake_up_step_; }
+
+  /// Called by the scheduler for dormant simulation objects before step
+  /// `step` is executed. Evaluates conditions (1) and (4) of `Sleep`.
+  /// Returns true if this simulation object woke up.
+  bool CheckWakeUp(uint64_t step);
+
   /// Return simulation object pointer
   template <typename TSimObject = SimObject>
   SoPointer<TSimObject> GetSoPtr() const {
@@ -257,6 +300,13 @@ class SimObject {
   bool run_displacement_for_all_next_ts_ = false;  //!
   mutable bool run_displacement_next_ts_ = true;   //!
 
+  /// \see `Sleep`
+  /// Atomic, because neighbors might call `WakeUp` while the owner reads or
+  /// writes it. ROOT stores `std::atomic<T>` data members as `T`.
+  mutable std::atomic<bool> dormant_{false};
+  /// Simulation step at which a dormant simulation object wakes up
+  uint64_t wake_up_step_ = 0;
+
   /// @brief Function to copy biology modules from one structure to another
   /// @param event event will be passed on to biology module to determine
   ///        whether it should be copied to destination
@@ -273,7 +323,7 @@ class SimObject {
                                  decltype(biology_modules_) * other1,
                                  decltype(biology_modules_) * other2);
 
-  BDM_CLASS_DEF(SimObject, 1)
+  BDM_CLASS_DEF(SimObject, 2)
 };
 
 }  // namespace bdm
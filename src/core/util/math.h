@@ -40,6 +40,20 @@ struct Math {
     return dist_array.Norm();
   }
 
+  /// Returns the component of a distance vector that corresponds to the
+  /// closest periodic image in a periodic space of length `periodic_length`.
+  /// If `periodic_length` is zero, `distance` is returned unchanged.
+  static double MinimumImage(double distance, double periodic_length) {
+    if (periodic_length != 0) {
+      if (distance > 0.5 * periodic_length) {
+        return distance - periodic_length;
+      } else if (distance < -0.5 * periodic_length) {
+        return distance + periodic_length;
+      }
+    }
+    return distance;
+  }
+
   /// Returns the cross product of two vectors.
   /// @param a
   /// @param b
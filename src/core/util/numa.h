@@ -22,6 +22,7 @@
 #else
 
 #include <omp.h>
+#include <cstdlib>
 
 inline int numa_available() { return 0; }
 inline int numa_num_configured_nodes() { return 1; }
@@ -33,6 +34,10 @@ inline int numa_move_pages(int pid, unsigned long count, void **pages,
   return 0;
 }
 
+inline void *numa_alloc_onnode(size_t size, int) { return malloc(size); }
+inline void numa_free(void *mem, size_t) { free(mem); }
+inline void numa_tonode_memory(void *start, size_t size, int node) {}
+
 // on linux in <sched.h>, but missing on MacOS
 inline int sched_getcpu() { return 0; }
 
@@ -0,0 +1,100 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef CORE_UTIL_RADIX_SORT_H_
+#define CORE_UTIL_RADIX_SORT_H_
+
+#include <omp.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace bdm {
+
+/// @brief      Sorts the elements in `data` in ascending order of their 64 bit
+///             keys using a parallel least significant digit radix sort.
+///
+/// The sort is stable. Each pass processes eight bits of the key. Only the
+/// passes that are required to cover `key_bits` are executed.
+///
+/// @param      data      The elements to be sorted
+/// @param      buffer    Temporary storage; will be resized to the size of
+///                       `data`. Passing the same buffer for consecutive
+///                       calls avoids reallocations.
+/// @param[in]  key_bits  Number of least significant bits that are used in
+///                       the keys. Higher bits must be zero.
+/// @param[in]  key       Returns the `uint64_t` key of an element
+///
+template <typename T, typename TKey>
+void ParallelRadixSort(std::vector<T>* data, std::vector<T>* buffer,
+                       uint32_t key_bits, const TKey& key) {
+  constexpr uint64_t kRadixBits = 8;
+  constexpr uint64_t kRadix = 1 << kRadixBits;
+  const uint64_t size = data->size();
+  buffer->resize(size);
+
+  // histograms[thread][digit]
+  std::vector<std::array<uint64_t, kRadix>> histograms;
+  for (uint32_t shift = 0; shift < key_bits; shift += kRadixBits) {
+    auto& src = *data;
+    auto& dest = *buffer;
+#pragma omp parallel
+    {
+      const uint64_t tid = omp_get_thread_num();
+      const uint64_t num_threads = omp_get_num_threads();
+#pragma omp single
+      histograms.resize(num_threads);
+      // implicit barrier
+
+      const uint64_t chunk = (size + num_threads - 1) / num_threads;
+      const uint64_t start = std::min(size, tid * chunk);
+      const uint64_t end = std::min(size, start + chunk);
+
+      auto& histogram = histograms[tid];
+      histogram.fill(0);
+      for (uint64_t i = start; i < end; i++) {
+        histogram[(key(src[i]) >> shift) & (kRadix - 1)]++;
+      }
+#pragma omp barrier
+
+      // exclusive prefix sum over digits and threads; afterwards
+      // histograms[t][d] is the first destination index for digit d of
+      // thread t
+#pragma omp single
+      {
+        uint64_t sum = 0;
+        for (uint64_t d = 0; d < kRadix; d++) {
+          for (uint64_t t = 0; t < num_threads; t++) {
+            auto count = histograms[t][d];
+            histograms[t][d] = sum;
+            sum += count;
+          }
+        }
+      }
+      // implicit barrier
+
+      for (uint64_t i = start; i < end; i++) {
+        auto digit = (key(src[i]) >> shift) & (kRadix - 1);
+        dest[histogram[digit]++] = src[i];
+      }
+    }
+    data->swap(*buffer);
+  }
+}
+
+}  // namespace bdm
+
+#endif  // CORE_UTIL_RADIX_SORT_H_
@@ -26,7 +26,9 @@ namespace bdm {
 
 /// \brief This class stores information about each thread. (e.g. to which NUMA
 /// node it belongs to.)
-/// NB: Threads **must** be bound to CPUs using `OMP_PROC_BIND=true`.
+/// NB: Threads should be bound to CPUs using `OMP_PROC_BIND=true`. Otherwise,
+/// threads are assigned to NUMA nodes in equally sized blocks, which does
+/// not reflect on which CPU they actually run.
 class ThreadInfo {
  public:
   static ThreadInfo* GetInstance() {
@@ -55,6 +57,10 @@ class ThreadInfo {
   /// Return the maximum number of threads.
   int GetMaxThreads() const { return max_threads_; }
 
+  /// Returns true if openmp threads are bound to CPUs (`OMP_PROC_BIND`).
+  /// Only in this case, the thread to NUMA node mapping is accurate.
+  bool ThreadsArePinned() const { return threads_pinned_; }
+
   /// Renews the metadata.\n
   /// Whenever a thread is scheduled on a different cpu, e.g. using
   /// `numa_run_on_node`, `Renew()` must be called to update the thread
@@ -71,11 +77,17 @@ class ThreadInfo {
     numa_thread_id_.resize(max_threads_, 0);
     threads_in_numa_.resize(numa_nodes_, 0);
 
-// (openmp thread id -> numa node)
+    // (openmp thread id -> numa node)
+    if (threads_pinned_) {
 #pragma omp parallel
-    {
-      int tid = omp_get_thread_num();
-      thread_numa_mapping_[tid] = numa_node_of_cpu(sched_getcpu());
+      {
+        int tid = omp_get_thread_num();
+        thread_numa_mapping_[tid] = numa_node_of_cpu(sched_getcpu());
+      }
+    } else {
+      for (uint64_t t = 0; t < max_threads_; t++) {
+        thread_numa_mapping_[t] = t * numa_nodes_ / max_threads_;
+      }
     }
 
     // (numa -> number of associated threads), and
@@ -120,6 +132,8 @@ class ThreadInfo {
   uint64_t max_threads_;
   /// Number of NUMA nodes on this machine.
   uint16_t numa_nodes_;
+  /// True if openmp threads are bound to CPUs.
+  bool threads_pinned_;
 
   /// Contains the mapping thread id -> numa node \n
   /// vector position = omp_thread_id \n
@@ -138,11 +152,12 @@ class ThreadInfo {
   std::vector<int> threads_in_numa_;
 
   ThreadInfo() {
-    if (omp_get_proc_bind() != 1) {
-      Log::Fatal("ThreadInfo",
-                 "The environmental variable OMP_PROC_BIND must be set to "
-                 "true. On Linux run 'export OMP_PROC_BIND=true' prior to "
-                 "running BioDynaMo");
+    threads_pinned_ = omp_get_proc_bind() != omp_proc_bind_false;
+    if (!threads_pinned_) {
+      Log::Warning("ThreadInfo",
+                   "Threads are not bound to CPUs. Memory accesses might not "
+                   "be NUMA local. On Linux run 'export OMP_PROC_BIND=true' "
+                   "prior to running BioDynaMo");
     }
     Renew();
   }
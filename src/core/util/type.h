@@ -17,6 +17,7 @@
 
 #include <type_traits>
 #include <typeinfo>
+#include <utility>
 #include "core/shape.h"
 #include "core/util/string.h"
 
@@ -41,6 +42,21 @@ struct type_ternary_operator<false, T, U> {
 template <typename T>
 using raw_type = std::remove_pointer_t<std::decay_t<T>>;  // NOLINT
 
+class SimObject;
+
+/// Type trait which is `std::true_type` if `TLambda` can be called with a
+/// neighbor and its squared distance `(const SimObject*, double)` and
+/// `std::false_type` otherwise. Selects the implementation of the templated
+/// `ForEachNeighbor` functions.
+template <typename TLambda, typename = void>
+struct is_neighbor_distance_functor : std::false_type {};  // NOLINT
+
+template <typename TLambda>
+struct is_neighbor_distance_functor<
+    TLambda, decltype(void(std::declval<const TLambda&>()(
+                 std::declval<const SimObject*>(), 0.0)))>
+    : std::true_type {};
+
 /// Use this cast if you want to downcast an object to a known type with extra
 /// safety. The extra safety check will only be performed in Debug mode.
 template <typename TTo, typename TFrom>
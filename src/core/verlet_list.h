@@ -0,0 +1,199 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#ifndef CORE_VERLET_LIST_H_
+#define CORE_VERLET_LIST_H_
+
+#include <omp.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "core/container/math_array.h"
+#include "core/container/sim_object_vector.h"
+#include "core/resource_manager.h"
+#include "core/simulation.h"
+#include "core/util/thread_info.h"
+
+namespace bdm {
+
+/// Stores the neighbors of each simulation object within the interaction
+/// radius plus a skin distance (Verlet list).
+/// The list remains valid across iterations as long as no simulation object
+/// moved more than half the skin distance, none grew larger than the
+/// interaction radius, and no simulation object was added, removed or got a
+/// different `SoHandle`. Until then, each pair of simulation objects that is
+/// within the interaction radius is guaranteed to be in the list.
+/// Neighbors are stored in one contiguous array per numa node (compressed
+/// sparse row format).
+class VerletList {
+ public:
+  /// @brief      Builds the list for all simulation objects.
+  ///
+  /// @param[in]  interaction_radius  Largest search radius that can be
+  ///                                 answered from the list
+  /// @param[in]  skin    Additional distance that is added to the
+  ///                     interaction radius
+  /// @param[in]  search  Called with `(const SimObject* so, callback)`.
+  ///                     Must call `callback(SoHandle neighbor,
+  ///                     double squared_distance)` for each neighbor within
+  ///                     `interaction_radius + skin`; additional neighbors
+  ///                     are filtered out.
+  template <typename TSearch>
+  void Build(double interaction_radius, double skin, const TSearch& search) {
+    auto* rm = Simulation::GetActive()->GetResourceManager();
+    auto numa_nodes = thread_info_->GetNumaNodes();
+    interaction_radius_ = interaction_radius;
+    skin_ = skin;
+    const double cutoff = interaction_radius + skin;
+    const double squared_cutoff = cutoff * cutoff;
+
+    states_.resize();
+    offsets_.resize(numa_nodes);
+    neighbors_.resize(numa_nodes);
+    for (int n = 0; n < numa_nodes; n++) {
+      offsets_[n].resize(rm->GetNumSimObjects(n) + 1);
+      offsets_[n][0] = 0;
+    }
+
+    // count neighbors
+    rm->ApplyOnAllElementsParallelDynamic(
+        1000, [&](SimObject* so, SoHandle soh) {
+          uint64_t count = 0;
+          search(so, [&](SoHandle, double squared_distance) {
+            if (squared_distance < squared_cutoff) {
+              count++;
+            }
+          });
+          offsets_[soh.GetNumaNode()][soh.GetElementIdx() + 1] = count;
+          states_[soh] = {so->GetUid(), so->GetPosition()};
+        });
+
+    for (int n = 0; n < numa_nodes; n++) {
+      auto& offsets = offsets_[n];
+      for (uint64_t i = 1; i < offsets.size(); i++) {
+        offsets[i] += offsets[i - 1];
+      }
+      neighbors_[n].resize(offsets.back());
+    }
+
+    // store neighbors
+    rm->ApplyOnAllElementsParallelDynamic(
+        1000, [&](SimObject* so, SoHandle soh) {
+          auto numa = soh.GetNumaNode();
+          auto i = offsets_[numa][soh.GetElementIdx()];
+          search(so, [&](SoHandle neighbor, double squared_distance) {
+            if (squared_distance < squared_cutoff) {
+              neighbors_[numa][i++] = neighbor;
+            }
+          });
+        });
+
+    built_ = true;
+    num_builds_++;
+  }
+
+  /// Returns true if the list can still be used for the current state of
+  /// the simulation (see class description). Disables the list otherwise.
+  bool IsValid() {
+    if (!built_) {
+      return false;
+    }
+    auto* rm = Simulation::GetActive()->GetResourceManager();
+    for (int n = 0; n < thread_info_->GetNumaNodes(); n++) {
+      if (states_.size(n) != rm->GetNumSimObjects(n)) {
+        built_ = false;
+        return false;
+      }
+    }
+
+    const double max_displacement = 0.5 * skin_;
+    const double squared_max_displacement =
+        max_displacement * max_displacement;
+    std::atomic<bool> valid(true);
+    rm->ApplyOnAllElementsParallelDynamic(
+        1000, [&](SimObject* so, SoHandle soh) {
+          const auto& state = states_[soh];
+          if (state.uid_ != so->GetUid() ||
+              so->GetDiameter() > interaction_radius_) {
+            valid = false;
+            return;
+          }
+          const auto& position = so->GetPosition();
+          double squared_displacement = 0;
+          for (int i = 0; i < 3; i++) {
+            double d = position[i] - state.position_[i];
+            squared_displacement += d * d;
+          }
+          if (squared_displacement > squared_max_displacement) {
+            valid = false;
+          }
+        });
+    built_ = valid;
+    return valid;
+  }
+
+  /// Disables the list; `IsValid` returns false until it is rebuilt.
+  void Invalidate() { built_ = false; }
+
+  /// Returns true if neighbor queries can be answered from this list (i.e.
+  /// it has been built and not been invalidated since)
+  bool IsBuilt() const { return built_; }
+
+  /// Applies the given lambda to the `SoHandle` of each neighbor of the
+  /// simulation object with the given handle.
+  template <typename TLambda>
+  void ForEachNeighbor(SoHandle handle, const TLambda& lambda) const {
+    const auto& offsets = offsets_[handle.GetNumaNode()];
+    const auto& neighbors = neighbors_[handle.GetNumaNode()];
+    auto end = offsets[handle.GetElementIdx() + 1];
+    for (auto i = offsets[handle.GetElementIdx()]; i < end; i++) {
+      lambda(neighbors[i]);
+    }
+  }
+
+  /// Returns the largest search radius that can be answered from this list
+  double GetInteractionRadius() const { return interaction_radius_; }
+
+  double GetSkin() const { return skin_; }
+
+  /// Returns how often the list has been built
+  uint64_t GetNumBuilds() const { return num_builds_; }
+
+ private:
+  /// State of a simulation object when the list was built
+  struct State {
+    SoUid uid_;
+    Double3 position_;
+  };
+
+  ThreadInfo* thread_info_ = ThreadInfo::GetInstance();
+  /// One `State` for each simulation object
+  SimObjectVector<State> states_;
+  /// numa node -> index of the first neighbor of each simulation object in
+  /// `neighbors_`; has one more element than simulation objects
+  std::vector<std::vector<uint64_t>> offsets_;
+  /// numa node -> neighbors of all simulation objects
+  std::vector<std::vector<SoHandle>> neighbors_;
+  double interaction_radius_ = 0;
+  double skin_ = 0;
+  bool built_ = false;
+  uint64_t num_builds_ = 0;
+};
+
+}  // namespace bdm
+
+#endif  // CORE_VERLET_LIST_H_
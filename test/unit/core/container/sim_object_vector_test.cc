@@ -43,4 +43,27 @@ TEST(SimObjectVectorTest, All) {
   EXPECT_EQ(0u, vector.size(0));
 }
 
+TEST(SimObjectVectorTest, Resize) {
+  std::string sim_name("simulation_object_vector_test_Resize");
+  Simulation simulation(sim_name);
+  auto* rm = simulation.GetResourceManager();
+
+  rm->push_back(new TestSimObject());
+  rm->push_back(new TestSimObject());
+
+  SimObjectVector<int> vector;
+  vector.resize();
+  EXPECT_EQ(2u, vector.size(0));
+  vector[SoHandle(0, 0)] = 1;
+  vector[SoHandle(0, 1)] = 2;
+
+  // existing values are kept; new ones are value initialized
+  rm->push_back(new TestSimObject());
+  vector.resize();
+  EXPECT_EQ(3u, vector.size(0));
+  EXPECT_EQ(1, vector[SoHandle(0, 0)]);
+  EXPECT_EQ(2, vector[SoHandle(0, 1)]);
+  EXPECT_EQ(0, vector[SoHandle(0, 2)]);
+}
+
 }  // namespace bdm
@@ -0,0 +1,113 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#include "core/container/so_uid_map.h"
+#include <gtest/gtest.h>
+#include "core/resource_manager.h"
+
+namespace bdm {
+
+TEST(SoUidMapTest, InsertContainsRemove) {
+  SoUidMap<SoHandle> map(10);
+  EXPECT_EQ(10u, map.size());
+  for (SoUid uid = 0; uid < 20; uid++) {
+    EXPECT_FALSE(map.Contains(uid));
+    EXPECT_EQ(SoHandle(), map.Get(uid));
+  }
+
+  map.Insert(3, SoHandle(1, 2));
+  map.Insert(9, SoHandle(0, 0));
+  EXPECT_TRUE(map.Contains(3));
+  EXPECT_TRUE(map.Contains(9));
+  EXPECT_FALSE(map.Contains(4));
+  EXPECT_EQ(SoHandle(1, 2), map[3]);
+  EXPECT_EQ(SoHandle(0, 0), map.Get(9));
+
+  // resize keeps the entries
+  map.resize(100);
+  EXPECT_EQ(100u, map.size());
+  EXPECT_EQ(SoHandle(1, 2), map[3]);
+  map.Insert(99, SoHandle(3, 4));
+  EXPECT_TRUE(map.Contains(99));
+
+  // resize never shrinks
+  map.resize(5);
+  EXPECT_EQ(100u, map.size());
+
+  map.Remove(3);
+  map.Remove(1000);
+  EXPECT_FALSE(map.Contains(3));
+  EXPECT_EQ(SoHandle(), map.Get(3));
+  EXPECT_TRUE(map.Contains(9));
+
+  map.clear();
+  EXPECT_EQ(0u, map.size());
+  EXPECT_FALSE(map.Contains(9));
+}
+
+TEST(SoUidMapTest, FirstUidAndCompact) {
+  SoUidMap<SoHandle> map;
+  map.clear(1000);
+  EXPECT_EQ(1000u, map.GetFirstUid());
+  EXPECT_EQ(1000u, map.size());
+  EXPECT_EQ(0u, map.capacity());
+
+  // only the range [1000, 1010) is allocated
+  map.resize(1010);
+  EXPECT_EQ(10u, map.capacity());
+  EXPECT_FALSE(map.Contains(5));
+  EXPECT_EQ(SoHandle(), map.Get(5));
+  map.Remove(5);
+  map.Insert(1003, SoHandle(0, 3));
+  map.Insert(1006, SoHandle(0, 6));
+  EXPECT_EQ(SoHandle(0, 3), map[1003]);
+
+  // grow towards smaller uids
+  map.ReserveFrom(990);
+  EXPECT_EQ(990u, map.GetFirstUid());
+  EXPECT_EQ(20u, map.capacity());
+  map.Insert(995, SoHandle(1, 5));
+  EXPECT_EQ(SoHandle(0, 3), map[1003]);
+  EXPECT_EQ(SoHandle(0, 6), map[1006]);
+
+  map.Remove(995);
+  map.Compact(2000);
+  EXPECT_EQ(1003u, map.GetFirstUid());
+  EXPECT_EQ(4u, map.capacity());
+  EXPECT_EQ(1007u, map.size());
+  EXPECT_EQ(SoHandle(0, 3), map[1003]);
+  EXPECT_EQ(SoHandle(0, 6), map[1006]);
+  EXPECT_FALSE(map.Contains(995));
+
+  // an empty map restarts at the given uid
+  map.Remove(1003);
+  map.Remove(1006);
+  map.Compact(2000);
+  EXPECT_EQ(2000u, map.GetFirstUid());
+  EXPECT_EQ(0u, map.capacity());
+}
+
+TEST(SoUidMapTest, ParallelInsert) {
+  const uint64_t size = 100000;
+  SoUidMap<SoHandle> map(size);
+#pragma omp parallel for
+  for (uint64_t uid = 0; uid < size; uid++) {
+    map.Insert(uid, SoHandle(uid % 2, uid));
+  }
+  for (uint64_t uid = 0; uid < size; uid++) {
+    EXPECT_EQ(SoHandle(uid % 2, uid), map[uid]);
+  }
+}
+
+}  // namespace bdm
@@ -64,6 +64,27 @@ TEST(DefaultForce, AllNonOverlappingSphere) {
   EXPECT_NEAR(0, result[2], abs_error<double>::value);
 }
 
+/// With periodic boundaries the force is calculated for the closest periodic
+/// image of the neighbor
+TEST(DefaultForce, PeriodicSphere) {
+  Cell cell({1, 2, 98});
+  cell.SetDiameter(8);
+  Cell nb({99, 1, 1});
+  nb.SetDiameter(6);
+  Cell nb_image({-1, 1, 101});
+  nb_image.SetDiameter(6);
+
+  DefaultForce periodic_force(100);
+  auto result = periodic_force.GetForce(&cell, &nb);
+  DefaultForce force;
+  auto expected = force.GetForce(&cell, &nb_image);
+
+  EXPECT_GT(std::abs(expected[0]), 1);
+  EXPECT_NEAR(expected[0], result[0], abs_error<double>::value);
+  EXPECT_NEAR(expected[1], result[1], abs_error<double>::value);
+  EXPECT_NEAR(expected[2], result[2], abs_error<double>::value);
+}
+
 /// Tests the special case that neighbor and reference cell
 /// are at the same position -> should return random force
 TEST(DefaultForce, AllAtSamePositionSphere) {
@@ -276,6 +276,298 @@ TEST(DiffusionTest, ClosedEdge) {
   delete d_grid;
 }
 
+// Secretion of several threads into the same box must not lose updates.
+TEST(DiffusionTest, ParallelSecretion) {
+  Simulation simulation(TEST_NAME);
+
+  DiffusionGrid d_grid(0, "Kalium", 0.4, 0, 5);
+  d_grid.Initialize({-100, 100, -100, 100, -100, 100});
+  d_grid.SetConcentrationThreshold(15000);
+
+  Double3 center = {0, 0, 0};
+  Double3 corner = {-100, -100, -100};
+#pragma omp parallel for
+  for (int i = 0; i < 10000; i++) {
+    d_grid.IncreaseConcentrationBy(center, 1);
+    d_grid.IncreaseConcentrationBy(corner, 2);
+  }
+
+  // secretion inside a parallel region is buffered
+  if (omp_get_max_threads() > 1) {
+    EXPECT_EQ(0, d_grid.GetConcentration(center));
+  }
+
+  d_grid.CommitSecretion();
+  EXPECT_EQ(10000, d_grid.GetConcentration(center));
+  // the threshold is applied after all amounts have been added
+  EXPECT_EQ(15000, d_grid.GetConcentration(corner));
+
+  // nothing left to commit
+  d_grid.CommitSecretion();
+  EXPECT_EQ(10000, d_grid.GetConcentration(center));
+}
+
+// Threads without a secretion buffer, e.g. because the number of threads was
+// increased after initialization or because of nested parallel regions,
+// must not lose updates either.
+TEST(DiffusionTest, ParallelSecretionWithoutBuffer) {
+  Simulation simulation(TEST_NAME);
+
+  DiffusionGrid d_grid(0, "Kalium", 0.4, 0, 5);
+  auto max_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  d_grid.Initialize({-100, 100, -100, 100, -100, 100});
+  omp_set_num_threads(max_threads);
+
+  Double3 center = {0, 0, 0};
+  int nested = 0;
+#pragma omp parallel num_threads(4)
+  {
+#pragma omp for
+    for (int i = 0; i < 10000; i++) {
+      d_grid.IncreaseConcentrationBy(center, 1);
+    }
+#pragma omp parallel num_threads(2)
+    {
+      d_grid.IncreaseConcentrationBy(center, 1);
+#pragma omp atomic
+      nested++;
+    }
+  }
+
+  d_grid.CommitSecretion();
+  EXPECT_EQ(10000 + nested, d_grid.GetConcentration(center));
+}
+
+// Diffusing several grids in one sweep must give the same results as
+// diffusing them one after another.
+TEST(DiffusionTest, FusedDiffusion) {
+  Simulation simulation(TEST_NAME);
+
+  for (bool leaking_edges : {true, false}) {
+    std::vector<DiffusionGrid*> separate;
+    std::vector<DiffusionGrid*> fused;
+    for (int i = 0; i < 3; i++) {
+      // the last substance does not diffuse
+      double dc = i == 2 ? 0 : 0.4;
+      double mu = i == 2 ? 0 : 0.01;
+      separate.push_back(new DiffusionGrid(i, "Substance", dc, mu, 11));
+      fused.push_back(new DiffusionGrid(i, "Substance", dc, mu, 11));
+    }
+    for (auto& grids : {separate, fused}) {
+      for (int i = 0; i < 3; i++) {
+        grids[i]->Initialize({-100, 100, -100, 100, -100, 100});
+        grids[i]->IncreaseConcentrationBy({10.0 * i, 0, 0}, 4 + i);
+        grids[i]->IncreaseConcentrationBy({-99, -99, -99}, 7);
+      }
+    }
+
+    for (int step = 0; step < 10; step++) {
+      for (auto* dg : separate) {
+        if (leaking_edges) {
+          dg->DiffuseEulerLeakingEdge();
+        } else {
+          dg->DiffuseEuler();
+        }
+        dg->CalculateGradient();
+      }
+      DiffusionGrid::DiffuseAndCalculateGradients(fused, leaking_edges, true);
+    }
+
+    auto eps = abs_error<double>::value;
+    for (int i = 0; i < 3; i++) {
+      auto num_boxes = separate[i]->GetNumBoxes();
+      auto* expected_conc = separate[i]->GetAllConcentrations();
+      auto* actual_conc = fused[i]->GetAllConcentrations();
+      for (size_t b = 0; b < num_boxes; b++) {
+        EXPECT_NEAR(expected_conc[b], actual_conc[b], eps);
+      }
+      auto* expected_grad = separate[i]->GetAllGradients();
+      auto* actual_grad = fused[i]->GetAllGradients();
+      for (size_t b = 0; b < 3 * num_boxes; b++) {
+        EXPECT_NEAR(expected_grad[b], actual_grad[b], eps);
+      }
+      delete separate[i];
+      delete fused[i];
+    }
+  }
+}
+
+// Temporal blocking must give the same results as performing the diffusion
+// steps one after another.
+TEST(DiffusionTest, TimeBlocked) {
+  Simulation simulation(TEST_NAME);
+
+  for (bool leaking_edges : {true, false}) {
+    DiffusionGrid expected(0, "Kalium", 0.4, 0.01, 13);
+    DiffusionGrid actual(1, "Kalium", 0.4, 0.01, 13);
+    for (auto* dg : {&expected, &actual}) {
+      dg->Initialize({-100, 100, -100, 100, -100, 100});
+      dg->IncreaseConcentrationBy({0, 0, 0}, 10);
+      dg->IncreaseConcentrationBy({-99, -99, -99}, 7);
+      dg->IncreaseConcentrationBy({50, -20, 99}, 3);
+    }
+
+    for (int i = 0; i < 13; i++) {
+      if (leaking_edges) {
+        expected.DiffuseEulerLeakingEdge();
+      } else {
+        expected.DiffuseEuler();
+      }
+    }
+    actual.DiffuseEulerTimeBlocked(13, leaking_edges, 4);
+
+    auto eps = abs_error<double>::value;
+    for (size_t i = 0; i < expected.GetNumBoxes(); i++) {
+      EXPECT_NEAR(expected.GetAllConcentrations()[i],
+                  actual.GetAllConcentrations()[i], eps);
+    }
+  }
+}
+
+// The scheduler must split the time step of the grid over the substeps
+// without overwriting it, also if it is initialized more than once.
+TEST(DiffusionTest, SubstepTimeStep) {
+  auto set_param = [](auto* param) { param->diffusion_substeps_ = 4; };
+  Simulation simulation(TEST_NAME, set_param);
+  auto* rm = simulation.GetResourceManager();
+
+  rm->push_back(new Cell(10));
+  ModelInitializer::DefineSubstance(0, "Kalium", 0.4, 0, 5);
+  auto* dgrid = rm->GetDiffusionGrid(0);
+  dgrid->SetTimeStep(0.5);
+
+  for (int i = 0; i < 2; i++) {
+    simulation.GetScheduler()->Simulate(1);
+    EXPECT_EQ(4u, dgrid->GetNumSubsteps());
+    EXPECT_NEAR(0.5, dgrid->GetTimeStep(), abs_error<double>::value);
+    EXPECT_NEAR(0.125, dgrid->GetSubstepTimeStep(), abs_error<double>::value);
+  }
+}
+
+// Updating only the bricks with non-zero concentration must give the same
+// results as updating the whole grid.
+TEST(DiffusionTest, Sparse) {
+  Simulation simulation(TEST_NAME);
+
+  for (bool leaking_edges : {true, false}) {
+    DiffusionGrid dense(0, "Kalium", 0.4, 0.01, 41);
+    DiffusionGrid sparse(1, "Kalium", 0.4, 0.01, 41);
+    sparse.SetSparse(true);
+    for (auto* dg : {&dense, &sparse}) {
+      dg->Initialize({-100, 100, -100, 100, -100, 100});
+      dg->IncreaseConcentrationBy({0, 0, 0}, 10);
+      dg->IncreaseConcentrationBy({-99, -99, -99}, 7);
+    }
+
+    auto eps = abs_error<double>::value;
+    for (int i = 0; i < 20; i++) {
+      if (i == 10) {
+        dense.IncreaseConcentrationBy({60, -20, 99}, 3);
+        sparse.IncreaseConcentrationBy({60, -20, 99}, 3);
+      }
+      if (leaking_edges) {
+        dense.DiffuseEulerLeakingEdge();
+        sparse.DiffuseEulerLeakingEdge();
+      } else {
+        dense.DiffuseEuler();
+        sparse.DiffuseEuler();
+      }
+      for (size_t b = 0; b < dense.GetNumBoxes(); b++) {
+        ASSERT_NEAR(dense.GetAllConcentrations()[b],
+                    sparse.GetAllConcentrations()[b], eps);
+      }
+    }
+    // the substance has not reached most parts of the grid yet
+    EXPECT_LT(0u, sparse.GetNumZeroBricks());
+  }
+}
+
+// Kernels that update the whole grid must keep the brick information, so that
+// they can be mixed with the sparse kernel.
+TEST(DiffusionTest, SparseMixedKernels) {
+  Simulation simulation(TEST_NAME);
+
+  for (bool leaking_edges : {true, false}) {
+    DiffusionGrid dense(0, "Kalium", 0.4, 0.01, 41);
+    DiffusionGrid sparse(1, "Kalium", 0.4, 0.01, 41);
+    sparse.SetSparse(true);
+    for (auto* dg : {&dense, &sparse}) {
+      dg->Initialize({-100, 100, -100, 100, -100, 100});
+      dg->IncreaseConcentrationBy({0, 0, 0}, 10);
+      dg->IncreaseConcentrationBy({-99, -99, -99}, 7);
+    }
+
+    auto eps = abs_error<double>::value;
+    for (int i = 0; i < 3; i++) {
+      dense.DiffuseEulerTimeBlocked(3, leaking_edges);
+      sparse.DiffuseEulerSparse(leaking_edges);
+      sparse.DiffuseEulerTimeBlocked(2, leaking_edges);
+      // the substance has not reached most parts of the grid yet
+      EXPECT_LT(0u, sparse.GetNumZeroBricks());
+      for (size_t b = 0; b < dense.GetNumBoxes(); b++) {
+        ASSERT_NEAR(dense.GetAllConcentrations()[b],
+                    sparse.GetAllConcentrations()[b], eps);
+      }
+    }
+  }
+}
+
+// The implicit method must be stable for parameters that are not allowed for
+// the explicit method, conserve the substance with closed edges and apply the
+// decay.
+TEST(DiffusionTest, ADI) {
+  Simulation simulation(TEST_NAME);
+
+  // D * dt / box_length^2 = 1
+  DiffusionGrid d_grid(0, "Kalium", 1, 0, 51);
+  d_grid.SetDiffusionMethod(DiffusionGrid::kADI);
+  d_grid.Initialize({-25, 25, -25, 25, -25, 25});
+  d_grid.IncreaseConcentrationBy({0, 0, 0}, 1000);
+  d_grid.IncreaseConcentrationBy({-25, -25, -25}, 500);
+
+  auto num_boxes = d_grid.GetNumBoxes();
+  auto* conc = d_grid.GetAllConcentrations();
+  auto total = [&]() {
+    double sum = 0;
+    for (size_t i = 0; i < num_boxes; i++) {
+      sum += conc[i];
+    }
+    return sum;
+  };
+
+  for (int i = 0; i < 10; i++) {
+    d_grid.DiffuseADI(false);
+    EXPECT_NEAR(1500, total(), 1e-8);
+  }
+  for (size_t i = 0; i < num_boxes; i++) {
+    EXPECT_LE(0, conc[i]);
+    EXPECT_GE(1000, conc[i]);
+  }
+  // the concentration is symmetric around the center
+  Double3 center = {0, 0, 0};
+  double c_east = d_grid.GetConcentration({1, 0, 0});
+  EXPECT_LT(c_east, d_grid.GetConcentration(center));
+  EXPECT_NEAR(c_east, d_grid.GetConcentration({-1, 0, 0}), 1e-12);
+  EXPECT_NEAR(c_east, d_grid.GetConcentration({0, 1, 0}), 1e-12);
+  EXPECT_NEAR(c_east, d_grid.GetConcentration({0, 0, -1}), 1e-12);
+
+  // substances leave the simulation space with leaking edges
+  d_grid.DiffuseADI(true);
+  EXPECT_GT(1500, total());
+
+  // decay of a uniform concentration
+  DiffusionGrid decay_grid(1, "Natrium", 1, 0.1, 11);
+  decay_grid.SetDiffusionMethod(DiffusionGrid::kADI);
+  decay_grid.Initialize({-10, 10, -10, 10, -10, 10});
+  decay_grid.AddInitializer([](double, double, double) { return 1; });
+  decay_grid.RunInitializers();
+  decay_grid.DiffuseADI(false);
+  for (size_t i = 0; i < decay_grid.GetNumBoxes(); i++) {
+    EXPECT_NEAR(0.9, decay_grid.GetAllConcentrations()[i], 1e-12);
+  }
+}
+
 // Tests if the concentration / gradient values are correctly copied
 // after the grid has grown and DiffusionGrid::CopyOldData is called
 TEST(DiffusionTest, CopyOldData) {
@@ -357,6 +649,7 @@ TEST(DiffusionTest, IOTest) {
   d_grid->Initialize(dimensions);
   d_grid->SetConcentrationThreshold(42);
   d_grid->SetDecayConstant(0.01);
+  d_grid->SetDiffusionMethod(DiffusionGrid::kADI);
 
   // write to root file
   WritePersistentObject(ROOTFILE, "dgrid", *d_grid, "new");
@@ -370,6 +663,7 @@ TEST(DiffusionTest, IOTest) {
   EXPECT_EQ("Kalium", restored_d_grid->GetSubstanceName());
   EXPECT_EQ(10, restored_d_grid->GetBoxLength());
   EXPECT_EQ(42, restored_d_grid->GetConcentrationThreshold());
+  EXPECT_EQ(DiffusionGrid::kADI, restored_d_grid->GetDiffusionMethod());
   EXPECT_NEAR(0.4, restored_d_grid->GetDiffusionCoefficients()[0], eps);
   EXPECT_NEAR(0.1, restored_d_grid->GetDiffusionCoefficients()[1], eps);
   EXPECT_NEAR(0.1, restored_d_grid->GetDiffusionCoefficients()[2], eps);
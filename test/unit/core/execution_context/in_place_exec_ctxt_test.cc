@@ -13,6 +13,8 @@
 // -----------------------------------------------------------------------------
 
 #include <gtest/gtest.h>
+#include <functional>
+#include <set>
 
 #include "core/execution_context/in_place_exec_ctxt.h"
 #include "core/grid.h"
@@ -164,8 +166,8 @@ TEST(InPlaceExecutionContext, Execute) {
   EXPECT_TRUE(op2_called);
 }
 
-TEST(InPlaceExecutionContext, ExecuteThreadSafety) {
-  Simulation sim(TEST_NAME);
+void RunExecuteThreadSafetyTest(Simulation* simulation) {
+  auto& sim = *simulation;
   auto* rm = sim.GetResourceManager();
 
   // create cells
@@ -204,12 +206,18 @@ TEST(InPlaceExecutionContext, ExecuteThreadSafety) {
     num_neighbors[so->GetUid()] = nb_counter;
   });
 
-  rm->ApplyOnAllElementsParallel([&](SimObject* so) {
+  auto execute = [&](SimObject* so) {
     // ctxt must be obtained inside the lambda, otherwise we always get the
     // one corresponding to the master thread
     auto* ctxt = sim.GetExecutionContext();
     ctxt->Execute(so, {op});
-  });
+  };
+  if (sim.GetParam()->box_coloring_) {
+    sim.GetGrid()->ApplyOnAllElementsByBoxColor(
+        [&](SimObject* so, SoHandle) { execute(so); });
+  } else {
+    rm->ApplyOnAllElementsParallel(execute);
+  }
 
   rm->ApplyOnAllElements([&](SimObject* so) {
     // expected diameter: initial value + num_neighbors + 1
@@ -217,4 +225,102 @@ TEST(InPlaceExecutionContext, ExecuteThreadSafety) {
   });
 }
 
+TEST(InPlaceExecutionContext, ExecuteThreadSafety) {
+  Simulation simulation(TEST_NAME);
+  RunExecuteThreadSafetyTest(&simulation);
+}
+
+TEST(InPlaceExecutionContext, ExecuteThreadSafetyBoxColoring) {
+  auto set_param = [](auto* param) { param->box_coloring_ = true; };
+  Simulation simulation(TEST_NAME, set_param);
+  RunExecuteThreadSafetyTest(&simulation);
+}
+
+// Neighbor searches that are started while iterating over the neighbors of
+// another simulation object must return the neighbors of their own query.
+TEST(InPlaceExecutionContext, ForEachNeighborNested) {
+  Simulation sim(TEST_NAME);
+  auto* rm = sim.GetResourceManager();
+  auto* grid = sim.GetGrid();
+  auto* ctxt = sim.GetExecutionContext();
+
+  for (int i = 0; i < 10; i++) {
+    auto* cell = new Cell({i * 10.0, 0, 0});
+    cell->SetDiameter(10);
+    rm->push_back(cell);
+  }
+  grid->Initialize();
+
+  auto get_expected = [&](const SimObject* so) {
+    std::set<SoUid> expected;
+    grid->ForEachNeighbor(
+        [&](const SimObject* neighbor) { expected.insert(neighbor->GetUid()); },
+        *so);
+    return expected;
+  };
+
+  auto* query = rm->GetSimObjectWithSoHandle(SoHandle(0, 5));
+  std::set<SoUid> outer;
+  uint64_t num_nested = 0;
+  ctxt->ForEachNeighbor(
+      [&](const SimObject* neighbor, double squared_distance) {
+        outer.insert(neighbor->GetUid());
+        double dx = query->GetPosition()[0] - neighbor->GetPosition()[0];
+        EXPECT_NEAR(dx * dx, squared_distance, abs_error<double>::value);
+        std::set<SoUid> nested;
+        ctxt->ForEachNeighbor(
+            [&](const SimObject* nb) { nested.insert(nb->GetUid()); },
+            *neighbor);
+        EXPECT_EQ(get_expected(neighbor), nested);
+        num_nested++;
+      },
+      *query);
+  EXPECT_EQ(get_expected(query), outer);
+  EXPECT_EQ(outer.size(), num_nested);
+
+  // std::function overloads return the same neighbors
+  std::set<SoUid> within_radius;
+  std::function<void(const SimObject*)> insert =
+      [&](const SimObject* neighbor) {
+        within_radius.insert(neighbor->GetUid());
+      };
+  ctxt->ForEachNeighborWithinRadius(insert, *query, 101);
+  EXPECT_EQ(2u, within_radius.size());
+}
+
+// `Cell::CalculateDisplacement` must use the radius search of the grid,
+// which skips neighbor boxes outside the search sphere.
+TEST(InPlaceExecutionContext, CalculateDisplacementSkipsBoxes) {
+  auto set_param = [](auto* param) { param->statistics_ = true; };
+  Simulation sim(TEST_NAME, set_param);
+  auto* rm = sim.GetResourceManager();
+  auto* grid = sim.GetGrid();
+  auto* param = sim.GetParam();
+
+  auto ref_uid = SoUidGenerator::Get()->GetLastId();
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      for (size_t k = 0; k < 3; k++) {
+        auto* cell = new Cell({k * 20.0, j * 20.0, i * 20.0});
+        cell->SetDiameter(30);
+        rm->push_back(cell);
+      }
+    }
+  }
+  grid->Initialize();
+
+  // cell 13 at (20, 20, 20) is inside box [0, 30)^3
+  auto* query = rm->GetSimObject(ref_uid + 13);
+  auto displacement =
+      query->CalculateDisplacement(401, param->simulation_time_step_);
+  auto stats = grid->GetNeighborSearchStatistics();
+  EXPECT_EQ(26u, stats.visited_);
+  EXPECT_EQ(6u, stats.accepted_);
+  // boxes are pruned with the search radius plus the maximum displacement
+  // (see `Grid::GetPositionSlack`)
+  EXPECT_EQ(10u, stats.skipped_boxes_);
+  // the six neighbors are arranged symmetrically around the query
+  EXPECT_ARR_NEAR(displacement, {0, 0, 0});
+}
+
 }  // namespace bdm
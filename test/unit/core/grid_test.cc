@@ -13,6 +13,7 @@
 // -----------------------------------------------------------------------------
 
 #include "core/grid.h"
+#include "core/operation/bound_space_op.h"
 #include "core/sim_object/cell.h"
 #include "gtest/gtest.h"
 #include "unit/test_util/test_util.h"
@@ -168,6 +169,757 @@ TEST(GridTest, UpdateGrid) {
   RunUpdateGridTest(&simulation, ref_uid);
 }
 
+TEST(GridTest, IncrementalUpdateGrid) {
+  auto set_param = [](auto* param) { param->incremental_grid_update_ = true; };
+  Simulation simulation(TEST_NAME, set_param);
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+
+  auto ref_uid = SoUidGenerator::Get()->GetLastId();
+
+  CellFactory(rm, 4);
+
+  grid->Initialize();
+
+  // Remove cells 1 and 42
+  rm->Remove(ref_uid + 1);
+  rm->Remove(ref_uid + 42);
+
+  EXPECT_EQ(62u, rm->GetNumSimObjects());
+
+  RunUpdateGridTest(&simulation, ref_uid);
+}
+
+/// Compares the neighbors found by the grid with a brute force search
+void CheckNeighborsBruteForce(Simulation* simulation, double squared_radius) {
+  auto* rm = simulation->GetResourceManager();
+  auto* grid = simulation->GetGrid();
+
+  rm->ApplyOnAllElements([&](SimObject* so) {
+    std::set<SoUid> actual;
+    grid->ForEachNeighborWithinRadius(
+        [&](const SimObject* neighbor) { actual.insert(neighbor->GetUid()); },
+        *so, squared_radius);
+
+    std::set<SoUid> expected;
+    rm->ApplyOnAllElements([&](SimObject* other) {
+      if (other != so &&
+          grid->WithinSquaredEuclideanDistance(
+              squared_radius, so->GetPosition(), other->GetPosition())) {
+        expected.insert(other->GetUid());
+      }
+    });
+    EXPECT_EQ(expected, actual);
+  });
+}
+
+void RunMovedObjectsTest(Simulation* simulation) {
+  auto* rm = simulation->GetResourceManager();
+  auto* grid = simulation->GetGrid();
+
+  auto ref_uid = SoUidGenerator::Get()->GetLastId();
+
+  CellFactory(rm, 4);
+
+  grid->Initialize();
+  std::array<int32_t, 6> expected_dim = {{-30, 120, -30, 120, -30, 120}};
+  EXPECT_EQ(expected_dim, grid->GetDimensions());
+
+  // move, add and remove simulation objects without leaving the grid
+  for (int i = 0; i < 3; i++) {
+    rm->GetSimObject(ref_uid)->SetPosition({65, 65, 65});
+    rm->GetSimObject(ref_uid + 63)->SetPosition({5.0 * i, 5, 5});
+    rm->GetSimObject(ref_uid + 21)->SetPosition({41, 2, 88});
+    Cell* cell = new Cell({45.0 + i, 45, 45});
+    cell->SetDiameter(20);
+    rm->push_back(cell);
+    rm->Remove(ref_uid + 10 + i);
+
+    grid->UpdateGrid();
+    EXPECT_EQ(expected_dim, grid->GetDimensions());
+    if (simulation->GetParam()->incremental_grid_update_) {
+      EXPECT_FALSE(grid->HasGrown());
+    }
+    CheckNeighborsBruteForce(simulation, 900);
+  }
+
+  // leaving the grid triggers a full rebuild
+  rm->GetSimObject(ref_uid + 5)->SetPosition({200, 0, 0});
+  grid->UpdateGrid();
+  std::array<int32_t, 6> expected_dim_1 = {{-30, 240, -30, 120, -30, 120}};
+  EXPECT_EQ(expected_dim_1, grid->GetDimensions());
+  CheckNeighborsBruteForce(simulation, 900);
+
+  // growing objects trigger a full rebuild
+  rm->GetSimObject(ref_uid + 6)->SetDiameter(45);
+  grid->UpdateGrid();
+  EXPECT_EQ(45u, grid->GetBoxLength());
+  CheckNeighborsBruteForce(simulation, 2025);
+}
+
+TEST(GridTest, IncrementalUpdateGridMovedObjects) {
+  auto set_param = [](auto* param) { param->incremental_grid_update_ = true; };
+  Simulation simulation(TEST_NAME, set_param);
+  RunMovedObjectsTest(&simulation);
+}
+
+TEST(GridTest, SortedCellListUpdateGrid) {
+  auto set_param = [](auto* param) { param->sorted_cell_list_ = true; };
+  Simulation simulation(TEST_NAME, set_param);
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+
+  auto ref_uid = SoUidGenerator::Get()->GetLastId();
+
+  CellFactory(rm, 4);
+
+  grid->Initialize();
+
+  // Remove cells 1 and 42
+  rm->Remove(ref_uid + 1);
+  rm->Remove(ref_uid + 42);
+
+  RunUpdateGridTest(&simulation, ref_uid);
+}
+
+TEST(GridTest, SortedCellListMovedObjects) {
+  auto set_param = [](auto* param) { param->sorted_cell_list_ = true; };
+  Simulation simulation(TEST_NAME, set_param);
+  RunMovedObjectsTest(&simulation);
+}
+
+TEST(GridTest, SortedCellListIncrementalUpdate) {
+  auto set_param = [](auto* param) {
+    param->sorted_cell_list_ = true;
+    param->incremental_grid_update_ = true;
+  };
+  Simulation simulation(TEST_NAME, set_param);
+  RunMovedObjectsTest(&simulation);
+}
+
+TEST(GridTest, SortedCellListForEachNeighbor) {
+  auto set_param = [](auto* param) { param->sorted_cell_list_ = true; };
+  Simulation simulation(TEST_NAME, set_param);
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+
+  auto ref_uid = SoUidGenerator::Get()->GetLastId();
+
+  CellFactory(rm, 3);
+
+  grid->Initialize();
+
+  // objects are moved in place during an iteration; distances must be
+  // calculated from the current position and not from the last grid update
+  auto* moved = rm->GetSimObject(ref_uid + 14);
+  moved->SetPosition(moved->GetPosition() + Double3{1, 2, 3});
+
+  // cell 13 is in the center; all other cells are inside its Moore
+  // neighborhood
+  auto* query = rm->GetSimObject(ref_uid + 13);
+  uint64_t cnt = 0;
+  grid->ForEachNeighbor(
+      [&](const SimObject* neighbor, double squared_distance) {
+        EXPECT_NE(query, neighbor);
+        EXPECT_NEAR(grid->SquaredEuclideanDistance(query->GetPosition(),
+                                                   neighbor->GetPosition()),
+                    squared_distance, abs_error<double>::value);
+        cnt++;
+      },
+      *query);
+  EXPECT_EQ(26u, cnt);
+}
+
+uint64_t CountNeighborsOfCenterCell(Grid::Adjacency adjacency) {
+  Simulation simulation("GridTest_CountNeighborsOfCenterCell");
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+
+  auto ref_uid = SoUidGenerator::Get()->GetLastId();
+
+  CellFactory(rm, 3);
+
+  grid->Initialize(adjacency);
+
+  uint64_t cnt = 0;
+  grid->ForEachNeighbor([&](const SimObject*) { cnt++; },
+                        *rm->GetSimObject(ref_uid + 13));
+  return cnt;
+}
+
+TEST(GridTest, Adjacency) {
+  // cell 13 is inside box (1, 1, 1), which contains 8 cells. All other cells
+  // are inside boxes with larger box coordinates.
+  EXPECT_EQ(7u + 3 * 4, CountNeighborsOfCenterCell(Grid::kLow));
+  EXPECT_EQ(7u + 3 * 4 + 3 * 2, CountNeighborsOfCenterCell(Grid::kMedium));
+  EXPECT_EQ(26u, CountNeighborsOfCenterCell(Grid::kHigh));
+}
+
+TEST(GridTest, BoxLengthSmallerThanLargestObject) {
+  auto set_param = [](auto* param) { param->grid_box_length_ = 10; };
+  Simulation simulation(TEST_NAME, set_param);
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+
+  auto ref_uid = SoUidGenerator::Get()->GetLastId();
+
+  CellFactory(rm, 4);
+  rm->GetSimObject(ref_uid + 5)->SetDiameter(10);
+
+  grid->Initialize();
+  EXPECT_EQ(10u, grid->GetBoxLength());
+  // three layers of boxes are required to cover the largest object
+  std::array<int32_t, 6> expected_dim = {{-30, 100, -30, 100, -30, 100}};
+  EXPECT_EQ(expected_dim, grid->GetDimensions());
+
+  CheckNeighborsBruteForce(&simulation, 900);
+
+  // Remove cells 1 and 42
+  rm->Remove(ref_uid + 1);
+  rm->Remove(ref_uid + 42);
+  RunUpdateGridTest(&simulation, ref_uid);
+}
+
+TEST(GridTest, SearchRadiusLargerThanBoxLength) {
+  auto set_param = [](auto* param) {
+    param->grid_search_radius_ = 50;
+    param->sorted_cell_list_ = true;
+  };
+  Simulation simulation(TEST_NAME, set_param);
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+
+  CellFactory(rm, 5);
+
+  grid->Initialize();
+  EXPECT_EQ(30u, grid->GetBoxLength());
+
+  CheckNeighborsBruteForce(&simulation, 2500);
+}
+
+TEST(GridTest, ForEachNeighborWithinSmallRadius) {
+  Simulation simulation(TEST_NAME);
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+
+  CellFactory(rm, 4);
+  grid->Initialize();
+
+  CheckNeighborsBruteForce(&simulation, 100);
+  CheckNeighborsBruteForce(&simulation, 401);
+}
+
+TEST(GridTest, NeighborSearchStatistics) {
+  auto set_param = [](auto* param) { param->statistics_ = true; };
+  Simulation simulation(TEST_NAME, set_param);
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+
+  auto ref_uid = SoUidGenerator::Get()->GetLastId();
+
+  CellFactory(rm, 3);
+  grid->Initialize();
+
+  // cell 13 at (20, 20, 20) is inside box [0, 30)^3; all other neighbor
+  // boxes are at least 10 away
+  auto* query = rm->GetSimObject(ref_uid + 13);
+  grid->ForEachNeighborWithinRadius([](const SimObject*) {}, *query, 25);
+  auto stats = grid->GetNeighborSearchStatistics();
+  EXPECT_EQ(7u, stats.visited_);
+  EXPECT_EQ(0u, stats.accepted_);
+  EXPECT_EQ(26u, stats.skipped_boxes_);
+
+  grid->ResetNeighborSearchStatistics();
+  grid->ForEachNeighborWithinRadius([](const SimObject*) {}, *query, 401);
+  stats = grid->GetNeighborSearchStatistics();
+  EXPECT_EQ(26u, stats.visited_);
+  EXPECT_EQ(6u, stats.accepted_);
+  // boxes with a distance of at least 20 along two axes, or 20 along one and
+  // 10 along another one are skipped
+  EXPECT_EQ(16u, stats.skipped_boxes_);
+}
+
+TEST(GridTest, HalfNeighborBoxOffsets) {
+  Simulation simulation(TEST_NAME);
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+
+  CellFactory(rm, 3);
+  grid->Initialize();
+
+  size_t box_idx = grid->GetBoxIndex(Double3{20, 20, 20});
+  FixedSizeVector<size_t, 14> half_moore;
+  grid->GetHalfMooreBoxIndices(&half_moore, box_idx);
+  std::set<size_t> expected(half_moore.begin(), half_moore.end());
+
+  std::set<size_t> actual;
+  for (auto offset : grid->GetHalfNeighborBoxOffsets()) {
+    actual.insert(box_idx + offset);
+  }
+  EXPECT_EQ(14u, actual.size());
+  EXPECT_EQ(expected, actual);
+}
+
+void RunForEachNeighborPairTest(Simulation* simulation) {
+  auto* rm = simulation->GetResourceManager();
+  auto* grid = simulation->GetGrid();
+
+  CellFactory(rm, 5);
+  grid->Initialize();
+
+  const double squared_radius = 900;
+  std::set<std::pair<SoUid, SoUid>> expected;
+  rm->ApplyOnAllElements([&](SimObject* lhs) {
+    rm->ApplyOnAllElements([&](SimObject* rhs) {
+      if (lhs->GetUid() < rhs->GetUid() &&
+          grid->WithinSquaredEuclideanDistance(
+              squared_radius, lhs->GetPosition(), rhs->GetPosition())) {
+        expected.insert({lhs->GetUid(), rhs->GetUid()});
+      }
+    });
+  });
+
+  std::vector<std::vector<std::pair<SoUid, SoUid>>> pairs(
+      omp_get_max_threads());
+  grid->ForEachNeighborPairWithinRadius(
+      [&](SimObject* lhs, SoHandle lhs_handle, SimObject* rhs,
+          SoHandle rhs_handle) {
+        EXPECT_EQ(lhs, rm->GetSimObjectWithSoHandle(lhs_handle));
+        EXPECT_EQ(rhs, rm->GetSimObjectWithSoHandle(rhs_handle));
+        auto lhs_uid = lhs->GetUid();
+        auto rhs_uid = rhs->GetUid();
+        pairs[omp_get_thread_num()].push_back(
+            {std::min(lhs_uid, rhs_uid), std::max(lhs_uid, rhs_uid)});
+      },
+      squared_radius);
+
+  std::vector<std::pair<SoUid, SoUid>> all_pairs;
+  for (auto& thread_pairs : pairs) {
+    all_pairs.insert(all_pairs.end(), thread_pairs.begin(), thread_pairs.end());
+  }
+  // each pair must be visited exactly once
+  EXPECT_EQ(expected.size(), all_pairs.size());
+  std::set<std::pair<SoUid, SoUid>> actual(all_pairs.begin(), all_pairs.end());
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(GridTest, ForEachNeighborPairWithinRadius) {
+  Simulation simulation(TEST_NAME);
+  RunForEachNeighborPairTest(&simulation);
+}
+
+TEST(GridTest, ForEachNeighborPairWithinRadiusMultipleLayers) {
+  auto set_param = [](auto* param) { param->grid_box_length_ = 8; };
+  Simulation simulation(TEST_NAME, set_param);
+  RunForEachNeighborPairTest(&simulation);
+}
+
+void RunApplyOnAllElementsByBoxColorTest(Simulation* simulation) {
+  auto* rm = simulation->GetResourceManager();
+  auto* grid = simulation->GetGrid();
+
+  CellFactory(rm, 8);
+  grid->Initialize();
+
+  // number of simulation objects that are currently processed and have the
+  // box in their neighborhood
+  std::vector<std::atomic<int>> active(grid->GetNumBoxes());
+  for (auto& el : active) {
+    el = 0;
+  }
+  std::atomic<bool> overlap(false);
+  std::vector<std::vector<SoUid>> visited(omp_get_max_threads());
+  grid->ApplyOnAllElementsByBoxColor([&](SimObject* so, SoHandle handle) {
+    EXPECT_EQ(so, rm->GetSimObjectWithSoHandle(handle));
+    visited[omp_get_thread_num()].push_back(so->GetUid());
+    auto box_idx = so->GetBoxIdx();
+    for (auto offset : grid->GetNeighborBoxOffsets()) {
+      if (active[box_idx + offset]++ != 0) {
+        overlap = true;
+      }
+    }
+    for (auto offset : grid->GetNeighborBoxOffsets()) {
+      active[box_idx + offset]--;
+    }
+  });
+  EXPECT_FALSE(overlap);
+
+  // each simulation object must be visited exactly once
+  std::vector<SoUid> all_visited;
+  for (auto& thread_visited : visited) {
+    all_visited.insert(all_visited.end(), thread_visited.begin(),
+                       thread_visited.end());
+  }
+  EXPECT_EQ(rm->GetNumSimObjects(), all_visited.size());
+  std::set<SoUid> unique(all_visited.begin(), all_visited.end());
+  EXPECT_EQ(rm->GetNumSimObjects(), unique.size());
+}
+
+TEST(GridTest, ApplyOnAllElementsByBoxColor) {
+  Simulation simulation(TEST_NAME);
+  RunApplyOnAllElementsByBoxColorTest(&simulation);
+}
+
+TEST(GridTest, ApplyOnAllElementsByBoxColorMultipleLayers) {
+  auto set_param = [](auto* param) { param->grid_box_length_ = 8; };
+  Simulation simulation(TEST_NAME, set_param);
+  RunApplyOnAllElementsByBoxColorTest(&simulation);
+}
+
+/// Squared distance between two points in the periodic cube with the given
+/// edge length
+double PeriodicSquaredDistance(const Double3& pos1, const Double3& pos2,
+                               double length) {
+  double result = 0;
+  for (int i = 0; i < 3; i++) {
+    double d = std::abs(pos1[i] - pos2[i]);
+    d = std::min(d, length - d);
+    result += d * d;
+  }
+  return result;
+}
+
+void RunPeriodicBoundaryTest(Simulation* simulation) {
+  auto* rm = simulation->GetResourceManager();
+  auto* grid = simulation->GetGrid();
+  auto* random = simulation->GetRandom();
+  const double length = 105;
+  const double squared_radius = 100;
+
+  auto check_neighbors = [&]() {
+    rm->ApplyOnAllElements([&](SimObject* so) {
+      std::set<SoUid> actual;
+      grid->ForEachNeighborWithinRadius(
+          [&](const SimObject* neighbor) {
+            // each neighbor must be visited only once
+            EXPECT_TRUE(actual.insert(neighbor->GetUid()).second);
+          },
+          *so, squared_radius);
+
+      std::set<SoUid> expected;
+      rm->ApplyOnAllElements([&](SimObject* other) {
+        if (other != so && PeriodicSquaredDistance(so->GetPosition(),
+                                                   other->GetPosition(),
+                                                   length) < squared_radius) {
+          expected.insert(other->GetUid());
+        }
+      });
+      EXPECT_EQ(expected, actual);
+    });
+  };
+
+  // two cells next to each other across the boundary
+  auto ref_uid = SoUidGenerator::Get()->GetLastId();
+  rm->push_back(new Cell({1, 50, 104}));
+  rm->push_back(new Cell({104, 50, 1}));
+  for (int i = 0; i < 500; i++) {
+    rm->push_back(new Cell(random->UniformArray<3>(0, length)));
+  }
+  rm->ApplyOnAllElements([](SimObject* so) { so->SetDiameter(10); });
+
+  grid->Initialize();
+  // 10 inner boxes plus one padding box on each side; the last inner box
+  // also covers the remaining 5 units
+  std::array<int32_t, 6> expected_dim = {{-10, 110, -10, 110, -10, 110}};
+  EXPECT_EQ(expected_dim, grid->GetDimensions());
+  EXPECT_NEAR(8, grid->SquaredEuclideanDistance({1, 50, 104}, {104, 50, 1}),
+              abs_error<double>::value);
+  std::set<SoUid> neighbors;
+  grid->ForEachNeighborWithinRadius(
+      [&](const SimObject* neighbor) { neighbors.insert(neighbor->GetUid()); },
+      *rm->GetSimObject(ref_uid), squared_radius);
+  EXPECT_EQ(1u, neighbors.count(ref_uid + 1));
+  check_neighbors();
+
+  // move all cells and wrap them around
+  rm->ApplyOnAllElements([&](SimObject* so) {
+    so->SetPosition(so->GetPosition() + Double3{7, -3, 50});
+    ApplyPeriodicBoundary(so, 0, length);
+  });
+  grid->UpdateGrid();
+  EXPECT_EQ(expected_dim, grid->GetDimensions());
+  check_neighbors();
+}
+
+TEST(GridTest, PeriodicBoundary) {
+  auto set_param = [](auto* param) {
+    param->bound_space_ = true;
+    param->min_bound_ = 0;
+    param->max_bound_ = 105;
+    param->periodic_boundary_ = true;
+  };
+  Simulation simulation(TEST_NAME, set_param);
+  RunPeriodicBoundaryTest(&simulation);
+}
+
+TEST(GridTest, PeriodicBoundaryIncrementalSortedCellList) {
+  auto set_param = [](auto* param) {
+    param->bound_space_ = true;
+    param->min_bound_ = 0;
+    param->max_bound_ = 105;
+    param->periodic_boundary_ = true;
+    param->incremental_grid_update_ = true;
+    param->sorted_cell_list_ = true;
+  };
+  Simulation simulation(TEST_NAME, set_param);
+  RunPeriodicBoundaryTest(&simulation);
+}
+
+TEST(GridTest, PeriodicBoundaryPairsAndColoring) {
+  auto set_param = [](auto* param) {
+    param->bound_space_ = true;
+    param->min_bound_ = 0;
+    param->max_bound_ = 105;
+    param->periodic_boundary_ = true;
+  };
+  Simulation simulation(TEST_NAME, set_param);
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+  auto* random = simulation.GetRandom();
+  const double squared_radius = 100;
+
+  for (int i = 0; i < 500; i++) {
+    auto* cell = new Cell(random->UniformArray<3>(0, 105));
+    cell->SetDiameter(10);
+    rm->push_back(cell);
+  }
+  grid->Initialize();
+
+  std::set<std::pair<SoUid, SoUid>> expected;
+  rm->ApplyOnAllElements([&](SimObject* lhs) {
+    rm->ApplyOnAllElements([&](SimObject* rhs) {
+      if (lhs->GetUid() < rhs->GetUid() &&
+          PeriodicSquaredDistance(lhs->GetPosition(), rhs->GetPosition(),
+                                  105) < squared_radius) {
+        expected.insert({lhs->GetUid(), rhs->GetUid()});
+      }
+    });
+  });
+
+  // boxes at opposite faces are neighbors and must not be processed at the
+  // same time
+  std::vector<std::atomic<int>> active(grid->GetNumBoxes());
+  for (auto& el : active) {
+    el = 0;
+  }
+  std::atomic<bool> overlap(false);
+  std::vector<std::vector<std::pair<SoUid, SoUid>>> pairs(
+      omp_get_max_threads());
+  grid->ForEachNeighborPairWithinRadius(
+      [&](SimObject* lhs, SoHandle, SimObject* rhs, SoHandle) {
+        std::vector<uint32_t> boxes = {lhs->GetBoxIdx()};
+        if (rhs->GetBoxIdx() != lhs->GetBoxIdx()) {
+          boxes.push_back(rhs->GetBoxIdx());
+        }
+        for (auto box : boxes) {
+          if (active[box]++ != 0) {
+            overlap = true;
+          }
+        }
+        auto lhs_uid = lhs->GetUid();
+        auto rhs_uid = rhs->GetUid();
+        pairs[omp_get_thread_num()].push_back(
+            {std::min(lhs_uid, rhs_uid), std::max(lhs_uid, rhs_uid)});
+        for (auto box : boxes) {
+          active[box]--;
+        }
+      },
+      squared_radius);
+  EXPECT_FALSE(overlap);
+
+  std::vector<std::pair<SoUid, SoUid>> all_pairs;
+  for (auto& thread_pairs : pairs) {
+    all_pairs.insert(all_pairs.end(), thread_pairs.begin(), thread_pairs.end());
+  }
+  EXPECT_EQ(expected.size(), all_pairs.size());
+  std::set<std::pair<SoUid, SoUid>> actual(all_pairs.begin(), all_pairs.end());
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(GridTest, VerletList) {
+  auto set_param = [](auto* param) { param->verlet_skin_ = 5; };
+  Simulation simulation(TEST_NAME, set_param);
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+
+  auto ref_uid = SoUidGenerator::Get()->GetLastId();
+  CellFactory(rm, 4);
+  grid->Initialize();
+
+  const auto& verlet_list = grid->GetVerletList();
+  EXPECT_TRUE(verlet_list.IsBuilt());
+  EXPECT_EQ(1u, verlet_list.GetNumBuilds());
+  EXPECT_EQ(30, verlet_list.GetInteractionRadius());
+  // the neighbor boxes must cover the interaction radius plus the skin
+  EXPECT_EQ(125u, grid->GetNeighborBoxOffsets().size());
+  CheckNeighborsBruteForce(&simulation, 900);
+
+  // moving less than half the skin reuses the list
+  auto* cell = rm->GetSimObject(ref_uid + 5);
+  cell->SetPosition(cell->GetPosition() + Double3{2, 0, 0});
+  grid->UpdateGrid();
+  EXPECT_EQ(1u, verlet_list.GetNumBuilds());
+  CheckNeighborsBruteForce(&simulation, 900);
+
+  cell->SetPosition(cell->GetPosition() + Double3{0, -2, 0});
+  grid->UpdateGrid();
+  EXPECT_EQ(2u, verlet_list.GetNumBuilds());
+  CheckNeighborsBruteForce(&simulation, 900);
+
+  // adding a simulation object rebuilds the list
+  Cell* new_cell = new Cell({31, 33, 35});
+  new_cell->SetDiameter(10);
+  rm->push_back(new_cell);
+  grid->UpdateGrid();
+  EXPECT_EQ(3u, verlet_list.GetNumBuilds());
+  CheckNeighborsBruteForce(&simulation, 900);
+
+  // a larger search radius than the interaction radius uses the boxes
+  CheckNeighborsBruteForce(&simulation, 1200);
+}
+
+// Simulation objects that are moved after the grid update must still be found
+// by the pruned neighbor search. `max_move` is the maximum distance along each
+// axis.
+void RunPrunedSearchTest(Simulation* simulation, double max_move,
+                         double squared_radius) {
+  auto* rm = simulation->GetResourceManager();
+  auto* grid = simulation->GetGrid();
+  auto* random = simulation->GetRandom();
+
+  for (int i = 0; i < 1000; i++) {
+    auto* cell = new Cell(random->UniformArray<3>(0, 100));
+    cell->SetDiameter(30);
+    rm->push_back(cell);
+  }
+  grid->Initialize();
+
+  rm->ApplyOnAllElements([&](SimObject* so) {
+    so->SetPosition(so->GetPosition() +
+                    random->UniformArray<3>(-max_move, max_move));
+  });
+  CheckNeighborsBruteForce(simulation, squared_radius);
+}
+
+TEST(GridTest, PrunedSearchAfterMovingObjects) {
+  Simulation simulation(TEST_NAME);
+  // objects are moved in place without a grid update
+  double max_move = simulation.GetParam()->simulation_max_displacement_ / 2;
+  RunPrunedSearchTest(&simulation, max_move, 400);
+}
+
+TEST(GridTest, PrunedSearchAfterMovingObjectsVerletList) {
+  auto set_param = [](auto* param) { param->verlet_skin_ = 5; };
+  Simulation simulation(TEST_NAME, set_param);
+  // less than half the skin; the grid update is skipped
+  RunPrunedSearchTest(&simulation, 1.4, 1200);
+  simulation.GetGrid()->UpdateGrid();
+  EXPECT_EQ(1u, simulation.GetGrid()->GetVerletList().GetNumBuilds());
+  // the search radius is larger than the interaction radius of the Verlet
+  // list; neighbors are searched in the (stale) boxes
+  CheckNeighborsBruteForce(&simulation, 1200);
+}
+
+void RunPointQueryTest(Simulation* simulation, double periodic_length) {
+  auto* rm = simulation->GetResourceManager();
+  auto* grid = simulation->GetGrid();
+  auto* random = simulation->GetRandom();
+
+  for (int i = 0; i < 1000; i++) {
+    auto* cell = new Cell(random->UniformArray<3>(0, 100));
+    cell->SetDiameter(10);
+    rm->push_back(cell);
+  }
+  grid->Initialize();
+
+  auto distance = [&](const Double3& pos1, const Double3& pos2) {
+    if (periodic_length != 0) {
+      return PeriodicSquaredDistance(pos1, pos2, periodic_length);
+    }
+    return grid->SquaredEuclideanDistance(pos1, pos2);
+  };
+
+  // query positions inside and outside the simulation space
+  std::vector<Double3> positions = {{50, 50, 50}, {1, 99, 2}, {-40, 50, 120}};
+  for (int i = 0; i < 20; i++) {
+    positions.push_back(random->UniformArray<3>(0, 100));
+  }
+
+  // radius query; the radius is larger than the box length
+  const double squared_radius = 625;
+  std::vector<std::set<SoUid>> batched(positions.size());
+  grid->ForEachSimObjectWithinRadius(
+      [&](uint64_t query, SimObject* so, SoHandle, double) {
+#pragma omp critical
+        batched[query].insert(so->GetUid());
+      },
+      positions, squared_radius);
+  for (uint64_t i = 0; i < positions.size(); i++) {
+    std::set<SoUid> expected;
+    rm->ApplyOnAllElements([&](SimObject* so) {
+      if (distance(positions[i], so->GetPosition()) < squared_radius) {
+        expected.insert(so->GetUid());
+      }
+    });
+    std::set<SoUid> actual;
+    grid->ForEachSimObjectWithinRadius(
+        [&](SimObject* so, SoHandle handle, double squared_distance) {
+          EXPECT_EQ(so, rm->GetSimObjectWithSoHandle(handle));
+          EXPECT_NEAR(distance(positions[i], so->GetPosition()),
+                      squared_distance, abs_error<double>::value);
+          EXPECT_TRUE(actual.insert(so->GetUid()).second);
+        },
+        positions[i], squared_radius);
+    EXPECT_EQ(expected, actual);
+    EXPECT_EQ(expected, batched[i]);
+  }
+
+  // k nearest neighbors
+  const uint64_t k = 7;
+  std::vector<std::vector<Grid::NearestNeighbor>> knn;
+  grid->GetKNearestNeighbors(positions, k, &knn);
+  ASSERT_EQ(positions.size(), knn.size());
+  for (uint64_t i = 0; i < positions.size(); i++) {
+    std::vector<double> expected;
+    rm->ApplyOnAllElements([&](SimObject* so) {
+      expected.push_back(distance(positions[i], so->GetPosition()));
+    });
+    std::sort(expected.begin(), expected.end());
+    expected.resize(k);
+
+    std::vector<Grid::NearestNeighbor> result;
+    grid->GetKNearestNeighbors(positions[i], k, &result);
+    ASSERT_EQ(k, result.size());
+    ASSERT_EQ(k, knn[i].size());
+    for (uint64_t j = 0; j < k; j++) {
+      EXPECT_NEAR(expected[j], result[j].squared_distance_,
+                  abs_error<double>::value);
+      EXPECT_EQ(result[j].so_, knn[i][j].so_);
+    }
+  }
+
+  // more neighbors requested than simulation objects exist
+  std::vector<Grid::NearestNeighbor> all;
+  grid->GetKNearestNeighbors({50, 50, 50}, 2000, &all);
+  EXPECT_EQ(rm->GetNumSimObjects(), all.size());
+}
+
+TEST(GridTest, PointQueries) {
+  Simulation simulation(TEST_NAME);
+  RunPointQueryTest(&simulation, 0);
+}
+
+TEST(GridTest, PointQueriesPeriodicBoundary) {
+  auto set_param = [](auto* param) {
+    param->bound_space_ = true;
+    param->min_bound_ = 0;
+    param->max_bound_ = 100;
+    param->periodic_boundary_ = true;
+  };
+  Simulation simulation(TEST_NAME, set_param);
+  RunPointQueryTest(&simulation, 100);
+}
+
 TEST(GridTest, NoRaceConditionDuringUpdate) {
   Simulation simulation(TEST_NAME);
   auto* rm = simulation.GetResourceManager();
@@ -320,4 +1072,39 @@ TEST(GridTest, IterateZOrder) {
   }
 }
 
+TEST(GridTest, ZOrderIterator) {
+  Simulation simulation(TEST_NAME);
+  auto* rm = simulation.GetResourceManager();
+  auto* grid = simulation.GetGrid();
+
+  CellFactory(rm, 10);
+  grid->Initialize();
+
+  uint64_t cnt = 0;
+  uint64_t last_morton = 0;
+  for (auto it = grid->GetZOrderIterator(); !it.IsAtEnd(); ++it) {
+    auto* so = rm->GetSimObjectWithSoHandle(*it);
+    auto coord = grid->GetBoxCoordinates(so->GetBoxIdx());
+    auto morton = libmorton::morton3D_64_encode(coord[0], coord[1], coord[2]);
+    EXPECT_LE(last_morton, morton);
+    last_morton = morton;
+    cnt++;
+  }
+  EXPECT_EQ(rm->GetNumSimObjects(), cnt);
+}
+
+TEST(GridTest, ZOrderIteratorEmptyGrid) {
+  auto set_param = [](auto* param) {
+    param->bound_space_ = true;
+    param->min_bound_ = 0;
+    param->max_bound_ = 100;
+  };
+  Simulation simulation(TEST_NAME, set_param);
+  auto* grid = simulation.GetGrid();
+  grid->Initialize();
+
+  auto it = grid->GetZOrderIterator();
+  EXPECT_TRUE(it.IsAtEnd());
+}
+
 }  // namespace bdm
@@ -0,0 +1,168 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#include "core/memory/memory_manager.h"
+#include <omp.h>
+#include <set>
+#include <thread>
+#include <vector>
+#include "core/biology_module/grow_divide.h"
+#include "core/sim_object/cell.h"
+#include "core/util/thread_info.h"
+#include "gtest/gtest.h"
+
+namespace bdm {
+
+TEST(NumaPoolAllocatorTest, NewAndDelete) {
+  auto* thread_info = ThreadInfo::GetInstance();
+  NumaPoolAllocator allocator(48);
+  EXPECT_EQ(48u, allocator.GetBlockSize());
+
+  // more blocks than fit into one slab
+  const uint64_t num_blocks = 2 * NumaPoolAllocator::kSlabSize / 48;
+  std::set<char*> blocks;
+  for (uint64_t i = 0; i < num_blocks; i++) {
+    auto* block = static_cast<char*>(allocator.New());
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(block) % 16);
+    EXPECT_EQ(thread_info->GetNumaNode(omp_get_thread_num()),
+              NumaPoolAllocator::GetNumaNode(block));
+    EXPECT_TRUE(blocks.insert(block).second);
+  }
+  // blocks must not overlap
+  char* previous = nullptr;
+  for (auto* block : blocks) {
+    if (previous != nullptr) {
+      EXPECT_LE(previous + 48, block);
+    }
+    previous = block;
+  }
+
+  int nid = thread_info->GetNumaNode(omp_get_thread_num());
+  auto num_slabs = allocator.GetNumSlabs(nid);
+  EXPECT_LE(3u, num_slabs);
+
+  // freed blocks are reused
+  for (auto* block : blocks) {
+    allocator.Delete(block);
+  }
+  for (uint64_t i = 0; i < num_blocks; i++) {
+    EXPECT_NE(blocks.end(), blocks.find(static_cast<char*>(allocator.New())));
+  }
+  EXPECT_EQ(num_slabs, allocator.GetNumSlabs(nid));
+}
+
+TEST(NumaPoolAllocatorTest, ParallelNewAndDelete) {
+  auto* thread_info = ThreadInfo::GetInstance();
+  NumaPoolAllocator allocator(32);
+  const uint64_t num_blocks = 100000;
+  std::vector<uint64_t*> blocks(num_blocks);
+
+#pragma omp parallel for
+  for (uint64_t i = 0; i < num_blocks; i++) {
+    blocks[i] = static_cast<uint64_t*>(allocator.New());
+    *blocks[i] = i;
+    EXPECT_EQ(thread_info->GetNumaNode(omp_get_thread_num()),
+              NumaPoolAllocator::GetNumaNode(blocks[i]));
+  }
+  for (uint64_t i = 0; i < num_blocks; i++) {
+    EXPECT_EQ(i, *blocks[i]);
+  }
+
+  // free blocks on different threads than the ones that allocated them
+#pragma omp parallel for schedule(static, 1)
+  for (uint64_t i = 0; i < num_blocks; i++) {
+    allocator.Delete(blocks[num_blocks - i - 1]);
+  }
+
+  std::set<uint64_t*> unique;
+#pragma omp parallel for
+  for (uint64_t i = 0; i < num_blocks; i++) {
+    blocks[i] = static_cast<uint64_t*>(allocator.New());
+  }
+  for (auto* block : blocks) {
+    EXPECT_TRUE(unique.insert(block).second);
+  }
+}
+
+// Threads that are not managed by OpenMP report thread number 0. They must
+// not use the private free list of the master thread.
+TEST(NumaPoolAllocatorTest, NonOpenMPThreads) {
+  NumaPoolAllocator allocator(32);
+  const uint64_t num_threads = 4;
+  const uint64_t num_blocks = 10000;
+  std::vector<std::vector<uint64_t*>> blocks(num_threads + 1);
+
+  auto allocate = [&](uint64_t t) {
+    for (uint64_t i = 0; i < num_blocks; i++) {
+      blocks[t].push_back(static_cast<uint64_t*>(allocator.New()));
+      *blocks[t].back() = t * num_blocks + i;
+      if (i % 3 == 0) {
+        allocator.Delete(blocks[t].back());
+        blocks[t].pop_back();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (uint64_t t = 0; t < num_threads; t++) {
+    threads.emplace_back(allocate, t);
+  }
+  allocate(num_threads);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::set<uint64_t*> unique;
+  for (uint64_t t = 0; t <= num_threads; t++) {
+    for (auto* block : blocks[t]) {
+      EXPECT_TRUE(unique.insert(block).second);
+      EXPECT_EQ(t, *block / num_blocks);
+    }
+  }
+}
+
+TEST(MemoryManagerTest, SizeClasses) {
+  auto* mem_mgr = MemoryManager::GetInstance();
+  EXPECT_EQ(16u, mem_mgr->GetAllocator(1)->GetBlockSize());
+  EXPECT_EQ(16u, mem_mgr->GetAllocator(16)->GetBlockSize());
+  EXPECT_EQ(32u, mem_mgr->GetAllocator(17)->GetBlockSize());
+  EXPECT_EQ(mem_mgr->GetAllocator(17), mem_mgr->GetAllocator(32));
+  EXPECT_EQ(MemoryManager::kMaxBlockSize,
+            mem_mgr->GetAllocator(MemoryManager::kMaxBlockSize)
+                ->GetBlockSize());
+
+  // requests larger than kMaxBlockSize are served by the global operator new
+  auto size = MemoryManager::kMaxBlockSize + 1;
+  auto* p = static_cast<char*>(mem_mgr->New(size));
+  p[size - 1] = 1;
+  mem_mgr->Delete(p, size);
+}
+
+TEST(MemoryManagerTest, SimObjectsAndBiologyModules) {
+  auto* thread_info = ThreadInfo::GetInstance();
+  auto* cell = new Cell(10);
+  EXPECT_EQ(thread_info->GetNumaNode(omp_get_thread_num()),
+            NumaPoolAllocator::GetNumaNode(cell));
+  cell->AddBiologyModule(new GrowDivide());
+  auto* copy = cell->GetCopy();
+  EXPECT_EQ(thread_info->GetNumaNode(omp_get_thread_num()),
+            NumaPoolAllocator::GetNumaNode(copy));
+  auto* bm = copy->GetAllBiologyModules()[0];
+  EXPECT_EQ(thread_info->GetNumaNode(omp_get_thread_num()),
+            NumaPoolAllocator::GetNumaNode(bm));
+  delete cell;
+  delete copy;
+}
+
+}  // namespace bdm
@@ -13,6 +13,9 @@
 // -----------------------------------------------------------------------------
 
 #include "core/model_initializer.h"
+#include <algorithm>
+#include <set>
+#include <vector>
 #include "core/biology_module/biology_module.h"
 #include "core/resource_manager.h"
 #include "core/sim_object/cell.h"
@@ -115,5 +118,89 @@ TEST(ModelInitializerTest, CreateCellsRandom) {
   EXPECT_TRUE((pos_2[2] >= -100) && (pos_2[2] <= 100));
 }
 
+/// Returns the positions of all simulation objects sorted lexicographically
+std::vector<Double3> GetSortedPositions(ResourceManager* rm) {
+  std::vector<Double3> positions;
+  rm->ApplyOnAllElements(
+      [&](SimObject* so) { positions.push_back(so->GetPosition()); });
+  std::sort(positions.begin(), positions.end(),
+            [](const Double3& lhs, const Double3& rhs) {
+              return std::lexicographical_compare(lhs.begin(), lhs.end(),
+                                                  rhs.begin(), rhs.end());
+            });
+  return positions;
+}
+
+TEST(ModelInitializerTest, Grid3DParallel) {
+  Simulation simulation(TEST_NAME);
+  auto* rm = simulation.GetResourceManager();
+
+  std::array<size_t, 3> grid_dimensions = {5, 7, 9};
+  ModelInitializer::Grid3DParallel(grid_dimensions, 12, [](const Double3& pos) {
+    Cell* cell = new Cell(pos);
+    return cell;
+  });
+
+  EXPECT_EQ(315u, rm->GetNumSimObjects());
+  auto positions = GetSortedPositions(rm);
+  uint64_t i = 0;
+  for (size_t x = 0; x < 5; x++) {
+    for (size_t y = 0; y < 7; y++) {
+      for (size_t z = 0; z < 9; z++) {
+        EXPECT_ARR_EQ({x * 12.0, y * 12.0, z * 12.0}, positions[i++]);
+      }
+    }
+  }
+
+  // every sim object can be found with its uid
+  rm->ApplyOnAllElements([&](SimObject* so, SoHandle soh) {
+    EXPECT_EQ(so, rm->GetSimObject(so->GetUid()));
+    EXPECT_EQ(soh, rm->GetSoHandle(so->GetUid()));
+  });
+}
+
+TEST(ModelInitializerTest, CreateCellsParallel) {
+  Simulation simulation(TEST_NAME);
+  auto* rm = simulation.GetResourceManager();
+
+  std::vector<Double3> positions;
+  for (int i = 0; i < 1000; i++) {
+    positions.push_back({1.0 * i, 2.0 * i, -3.0 * i});
+  }
+
+  ModelInitializer::CreateCellsParallel(positions, [](const Double3& pos) {
+    Cell* cell = new Cell(pos);
+    return cell;
+  });
+
+  EXPECT_EQ(1000u, rm->GetNumSimObjects());
+  auto actual = GetSortedPositions(rm);
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_ARR_EQ(positions[i], actual[i]);
+  }
+}
+
+TEST(ModelInitializerTest, CreateCellsRandomParallel) {
+  Simulation simulation(TEST_NAME);
+  auto* rm = simulation.GetResourceManager();
+
+  ModelInitializer::CreateCellsRandomParallel(-100, 100, 1000,
+                                              [](const Double3& pos) {
+                                                Cell* cell = new Cell(pos);
+                                                return cell;
+                                              });
+
+  EXPECT_EQ(1000u, rm->GetNumSimObjects());
+  std::set<SoUid> uids;
+  rm->ApplyOnAllElements([&](SimObject* so) {
+    uids.insert(so->GetUid());
+    const auto& pos = so->GetPosition();
+    for (int i = 0; i < 3; i++) {
+      EXPECT_TRUE((pos[i] >= -100) && (pos[i] <= 100));
+    }
+  });
+  EXPECT_EQ(1000u, uids.size());
+}
+
 }  // namespace model_initializer_test_internal
 }  // namespace bdm
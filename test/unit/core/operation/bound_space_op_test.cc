@@ -0,0 +1,57 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#include "core/operation/bound_space_op.h"
+#include "core/sim_object/cell.h"
+#include "gtest/gtest.h"
+#include "unit/test_util/test_util.h"
+
+namespace bdm {
+
+TEST(BoundSpaceTest, ClampPosition) {
+  auto set_param = [](auto* param) {
+    param->bound_space_ = true;
+    param->min_bound_ = -10;
+    param->max_bound_ = 10;
+  };
+  Simulation simulation(TEST_NAME, set_param);
+
+  Cell cell({-12, 3, 15});
+  BoundSpace op;
+  op(&cell);
+
+  EXPECT_ARR_NEAR(cell.GetPosition(), {-10, 3, 10 - 1e-10});
+}
+
+TEST(BoundSpaceTest, PeriodicBoundary) {
+  auto set_param = [](auto* param) {
+    param->bound_space_ = true;
+    param->min_bound_ = -10;
+    param->max_bound_ = 10;
+    param->periodic_boundary_ = true;
+  };
+  Simulation simulation(TEST_NAME, set_param);
+
+  Cell cell({-12, 3, 15});
+  BoundSpace op;
+  op(&cell);
+  EXPECT_ARR_NEAR(cell.GetPosition(), {8, 3, -5});
+
+  // the upper bound is not part of the simulation space
+  cell.SetPosition({10, 49, -30});
+  op(&cell);
+  EXPECT_ARR_NEAR(cell.GetPosition(), {-10, 9, -10});
+}
+
+}  // namespace bdm
@@ -0,0 +1,133 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#include "core/operation/displacement_op_symmetric.h"
+#include "core/grid.h"
+#include "core/sim_object/cell.h"
+#include "gtest/gtest.h"
+#include "unit/test_util/test_util.h"
+
+namespace bdm {
+namespace displacement_op_symmetric_test_internal {
+
+/// Compares the result of `DisplacementOpSymmetric` with displacements that
+/// are calculated for each cell separately (for the initial positions)
+void RunTest(Simulation* simulation) {
+  auto* rm = simulation->GetResourceManager();
+  auto* grid = simulation->GetGrid();
+  auto* param = simulation->GetParam();
+
+  grid->Initialize();
+
+  std::unordered_map<SoUid, Double3> expected;
+  auto squared_radius =
+      grid->GetLargestObjectSize() * grid->GetLargestObjectSize();
+  rm->ApplyOnAllElements([&](SimObject* so) {
+    expected[so->GetUid()] =
+        so->GetPosition() +
+        so->CalculateDisplacement(squared_radius,
+                                  param->simulation_time_step_);
+  });
+
+  DisplacementOpSymmetric op;
+  op();
+
+  rm->ApplyOnAllElements([&](SimObject* so) {
+    EXPECT_ARR_NEAR(expected[so->GetUid()], so->GetPosition());
+  });
+}
+
+TEST(DisplacementOpSymmetricTest, TwoCells) {
+  Simulation simulation(TEST_NAME);
+  auto* rm = simulation.GetResourceManager();
+
+  Cell* cell0 = new Cell();
+  cell0->SetAdherence(0.3);
+  cell0->SetDiameter(9);
+  cell0->SetMass(1.4);
+  cell0->SetPosition({0, 0, 0});
+  rm->push_back(cell0);
+
+  Cell* cell1 = new Cell();
+  cell1->SetAdherence(0.4);
+  cell1->SetDiameter(11);
+  cell1->SetMass(1.1);
+  cell1->SetPosition({0, 5, 0});
+  rm->push_back(cell1);
+
+  RunTest(&simulation);
+
+  EXPECT_NEAR(-0.07797206232558615, cell0->GetPosition()[1],
+              abs_error<double>::value);
+}
+
+// Dormant cells are not moved, but still push their neighbors away
+TEST(DisplacementOpSymmetricTest, DormantCell) {
+  Simulation simulation(TEST_NAME);
+  auto* rm = simulation.GetResourceManager();
+
+  Cell* cell0 = new Cell();
+  cell0->SetAdherence(0.3);
+  cell0->SetDiameter(9);
+  cell0->SetMass(1.4);
+  cell0->SetPosition({0, 0, 0});
+  rm->push_back(cell0);
+
+  Cell* cell1 = new Cell();
+  cell1->SetAdherence(0.4);
+  cell1->SetDiameter(11);
+  cell1->SetMass(1.1);
+  cell1->SetPosition({0, 5, 0});
+  cell1->Sleep();
+  rm->push_back(cell1);
+
+  simulation.GetGrid()->Initialize();
+  DisplacementOpSymmetric op;
+  op();
+
+  EXPECT_NEAR(-0.07797206232558615, cell0->GetPosition()[1],
+              abs_error<double>::value);
+  EXPECT_ARR_NEAR(cell1->GetPosition(), {0, 5, 0});
+}
+
+void CreateCells(ResourceManager* rm, size_t cells_per_dim) {
+  double space = 20;
+  for (size_t i = 0; i < cells_per_dim; i++) {
+    for (size_t j = 0; j < cells_per_dim; j++) {
+      for (size_t k = 0; k < cells_per_dim; k++) {
+        Cell* cell = new Cell({k * space, j * space, i * space});
+        cell->SetDiameter(30 - (i + j + k) % 3);
+        cell->SetAdherence(0.4);
+        cell->SetMass(1.0);
+        rm->push_back(cell);
+      }
+    }
+  }
+}
+
+TEST(DisplacementOpSymmetricTest, ManyCells) {
+  Simulation simulation(TEST_NAME);
+  CreateCells(simulation.GetResourceManager(), 6);
+  RunTest(&simulation);
+}
+
+TEST(DisplacementOpSymmetricTest, MultipleBoxLayers) {
+  auto set_param = [](auto* param) { param->grid_box_length_ = 12; };
+  Simulation simulation(TEST_NAME, set_param);
+  CreateCells(simulation.GetResourceManager(), 6);
+  RunTest(&simulation);
+}
+
+}  // namespace displacement_op_symmetric_test_internal
+}  // namespace bdm
@@ -0,0 +1,55 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#include <vector>
+
+#include "core/operation/fused_operation.h"
+#include "core/operation/operation.h"
+#include "core/sim_object/cell.h"
+#include "gtest/gtest.h"
+#include "unit/test_util/test_util.h"
+
+namespace bdm {
+
+struct CountingOp {
+  uint64_t* counter_;
+  void operator()(SimObject* so) { (*counter_)++; }
+};
+
+TEST(FusedOperationTest, ExecutionOrder) {
+  Simulation simulation(TEST_NAME);
+  Cell cell;
+
+  std::vector<int> calls;
+  uint64_t cnt = 0;
+  auto op1 = [&](SimObject* so) {
+    EXPECT_EQ(cell.GetUid(), so->GetUid());
+    calls.push_back(1);
+  };
+  auto op2 = [&](SimObject* so) { calls.push_back(2); };
+
+  auto fused = FuseOperations(op1, op2, CountingOp{&cnt}, op1);
+  fused(&cell);
+  EXPECT_EQ(std::vector<int>({1, 2, 1}), calls);
+  EXPECT_EQ(1u, cnt);
+
+  // fused operations can be wrapped in an Operation
+  auto op = Operation("fused", fused);
+  op(&cell);
+  op(&cell);
+  EXPECT_EQ(std::vector<int>({1, 2, 1, 1, 2, 1, 1, 2, 1}), calls);
+  EXPECT_EQ(3u, cnt);
+}
+
+}  // namespace bdm
@@ -46,6 +46,76 @@ TEST(ResourceManagerTest, SortAndApplyOnAllElementsParallelDynamic) {
   RunSortAndApplyOnAllElementsParallelDynamic();
 }
 
+TEST(ResourceManagerTest, RemoveSimObjects) {
+  ResourceManager rm;
+  std::vector<SoUid> uids;
+  for (int i = 0; i < 1000; i++) {
+    auto* so = new TestSimObject();
+    uids.push_back(so->GetUid());
+    rm.push_back(so);
+  }
+
+  // remove every third sim object and the last ten, some of them twice
+  std::vector<SoUid> remove;
+  for (int i = 0; i < 1000; i++) {
+    if (i % 3 == 0 || i >= 990) {
+      remove.push_back(uids[i]);
+    }
+  }
+  remove.push_back(uids[0]);
+  remove.push_back(uids[999]);
+  // uid that is not stored in the ResourceManager
+  remove.push_back(SoUidGenerator::Get()->NewSoUid());
+
+  rm.RemoveSimObjects(remove);
+
+  EXPECT_EQ(660u, rm.GetNumSimObjects());
+  for (int i = 0; i < 1000; i++) {
+    if (i % 3 == 0 || i >= 990) {
+      EXPECT_FALSE(rm.Contains(uids[i]));
+    } else {
+      ASSERT_TRUE(rm.Contains(uids[i]));
+      EXPECT_EQ(uids[i], rm.GetSimObject(uids[i])->GetUid());
+    }
+  }
+  rm.ApplyOnAllElements([&](SimObject* so, SoHandle soh) {
+    EXPECT_EQ(soh, rm.GetSoHandle(so->GetUid()));
+  });
+
+  rm.RemoveSimObjects({});
+  EXPECT_EQ(660u, rm.GetNumSimObjects());
+}
+
+// Work stealing must process each sim object exactly once, also if a few sim
+// objects are much more expensive than the others and the chunk size is
+// adapted between calls.
+TEST(ResourceManagerTest, ApplyOnAllElementsParallelDynamicImbalanced) {
+  ResourceManager rm;
+  for (int i = 0; i < 10000; i++) {
+    rm.push_back(new TestSimObject());
+  }
+
+  std::vector<std::atomic<uint64_t>> counts(rm.GetNumSimObjects());
+  for (auto& count : counts) {
+    count = 0;
+  }
+  for (int i = 0; i < 5; i++) {
+    rm.ApplyOnAllElementsParallelDynamic(100, [&](SimObject*, SoHandle soh) {
+      if (soh.GetElementIdx() % 1000 == 0) {
+        volatile double d = 0;
+        for (int j = 0; j < 100000; j++) {
+          d += std::sin(j);
+        }
+      }
+      counts[soh.GetElementIdx()]++;
+    });
+  }
+
+  for (auto& count : counts) {
+    EXPECT_EQ(5u, count.load());
+  }
+}
+
 TEST(ResourceManagerTest, DiffusionGrid) {
   ResourceManager rm;
 
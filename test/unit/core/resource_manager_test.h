@@ -305,7 +305,7 @@ inline void CheckApplyOnAllElements(ResourceManager* rm,
       if (numa_checks && handle.GetNumaNode() != GetNumaNodeForMemory(so)) {
         numa_memory_errors++;
       }
-      if (numa_checks &&
+      if (numa_checks && ti->ThreadsArePinned() &&
           handle.GetNumaNode() != numa_node_of_cpu(sched_getcpu())) {
         numa_thread_errors++;
       }
@@ -132,5 +132,118 @@ TEST(SchedulerTest, OperationManagement) {
   EXPECT_EQ(20u, op2_cnt);
 }
 
+// Accessing a built-in operation must not change the simulation, because the
+// fused and the unfused operations share the same DisplacementOp.
+TEST(SchedulerTest, GetBuiltinOperation) {
+  auto simulate = [](bool get_operation) {
+    Simulation simulation(TEST_NAME);
+    auto* rm = simulation.GetResourceManager();
+    auto* cell_1 = new Cell(10);
+    auto* cell_2 = new Cell(10);
+    cell_2->SetPosition({5, 0, 0});
+    auto uid = cell_2->GetUid();
+    rm->push_back(cell_1);
+    rm->push_back(cell_2);
+
+    auto* scheduler = simulation.GetScheduler();
+    scheduler->Simulate(5);
+    if (get_operation) {
+      EXPECT_EQ(1u, scheduler->GetOperation("displacement")->frequency_);
+    }
+    scheduler->Simulate(5);
+    return rm->GetSimObject(uid)->GetPosition();
+  };
+
+  auto expected = simulate(false);
+  auto actual = simulate(true);
+  EXPECT_ARR_NEAR(expected, actual);
+}
+
+// A replaced built-in operation must be executed instead of the built-in
+// function that is part of the fused operations.
+TEST(SchedulerTest, ReplaceBuiltinOperation) {
+  Simulation simulation(TEST_NAME);
+  simulation.GetResourceManager()->push_back(new Cell(10));
+
+  uint64_t cnt = 0;
+  auto* scheduler = simulation.GetScheduler();
+  *scheduler->GetOperation("displacement") =
+      Operation("displacement", [&](SimObject* so) { cnt++; });
+  scheduler->Simulate(10);
+  EXPECT_EQ(10u, cnt);
+}
+
+TEST(SchedulerTest, SortSimObjects) {
+  auto set_param = [](auto* param) { param->so_sort_frequency_ = 2; };
+  Simulation simulation(TEST_NAME, set_param);
+  auto* rm = simulation.GetResourceManager();
+
+  // add cells on a line in reverse order
+  std::vector<SoUid> uids;
+  for (int i = 0; i < 100; i++) {
+    auto* cell = new Cell(10);
+    cell->SetPosition({(99 - i) * 20.0, 0, 0});
+    uids.push_back(cell->GetUid());
+    rm->push_back(cell);
+  }
+
+  simulation.GetScheduler()->Simulate(1);
+
+  // sim objects must be sorted along the Z-order curve
+  double last_x = -1;
+  auto numa_nodes = ThreadInfo::GetInstance()->GetNumaNodes();
+  for (int n = 0; n < numa_nodes; n++) {
+    for (uint64_t i = 0; i < rm->GetNumSimObjects(n); i++) {
+      auto* so = rm->GetSimObjectWithSoHandle(SoHandle(n, i));
+      EXPECT_LT(last_x, so->GetPosition()[0]);
+      last_x = so->GetPosition()[0];
+      EXPECT_EQ(SoHandle(n, i), rm->GetSoHandle(so->GetUid()));
+    }
+  }
+  EXPECT_EQ(100u, rm->GetNumSimObjects());
+  for (uint64_t i = 0; i < uids.size(); i++) {
+    EXPECT_EQ((99 - i) * 20.0, rm->GetSimObject(uids[i])->GetPosition()[0]);
+  }
+}
+
+TEST(SchedulerTest, DormantSimObjects) {
+  Simulation simulation(TEST_NAME);
+  auto* rm = simulation.GetResourceManager();
+
+  auto* timer_cell = new Cell(10);
+  auto* sleeping_cell = new Cell(10);
+  sleeping_cell->SetPosition({100, 0, 0});
+  auto timer_uid = timer_cell->GetUid();
+  auto sleeping_uid = sleeping_cell->GetUid();
+  rm->push_back(timer_cell);
+  rm->push_back(sleeping_cell);
+
+  std::atomic<uint64_t> timer_cnt(0);
+  std::atomic<uint64_t> sleeping_cnt(0);
+  Operation op("count", [&](SimObject* so) {
+    if (so->GetUid() == timer_uid) {
+      // skip the next three steps
+      if (timer_cnt++ == 0) {
+        so->Sleep(3);
+      }
+    } else {
+      sleeping_cnt++;
+      so->Sleep();
+    }
+  });
+  auto* scheduler = simulation.GetScheduler();
+  scheduler->AddOperation(op);
+
+  scheduler->Simulate(10);
+  EXPECT_EQ(7u, timer_cnt.load());
+  EXPECT_EQ(1u, sleeping_cnt.load());
+  EXPECT_FALSE(rm->GetSimObject(timer_uid)->IsDormant());
+  EXPECT_TRUE(rm->GetSimObject(sleeping_uid)->IsDormant());
+
+  rm->GetSimObject(sleeping_uid)->WakeUp();
+  scheduler->Simulate(1);
+  EXPECT_EQ(2u, sleeping_cnt.load());
+}
+
 }  // namespace scheduler_test_internal
 }  // namespace bdm
@@ -77,6 +77,7 @@ inline void RunIOTest() {
   using GrowthModule = sim_object_test_internal::GrowthModule;
   using MovementModule = sim_object_test_internal::MovementModule;
   remove(ROOTFILE);
+  Simulation simulation("CellTest_RunIOTest");
 
   TestCell cell;
   cell.SetPosition({5, 6, 7});
@@ -88,6 +89,7 @@ inline void RunIOTest() {
   cell.AddBiologyModule(new GrowthModule());
   cell.AddBiologyModule(new MovementModule({1, 2, 3}));
   cell.SetBoxIdx(123);
+  cell.Sleep(5);
 
   // write to root file
   WritePersistentObject(ROOTFILE, "cell", cell, "new");
@@ -124,6 +126,8 @@ inline void RunIOTest() {
                   restored_cell->GetAllBiologyModules()[1]) != nullptr);
 
   EXPECT_EQ(123u, restored_cell->GetBoxIdx());
+  EXPECT_TRUE(restored_cell->IsDormant());
+  EXPECT_EQ(cell.GetWakeUpStep(), restored_cell->GetWakeUpStep());
 
   delete restored_cell;
   // delete root file
@@ -39,6 +39,9 @@ class SimulationTest : public ::testing::Test {
       "bound_space = true\n"
       "min_bound = -100\n"
       "max_bound =  200\n"
+      "periodic_boundary = true\n"
+      "diffusion_method = \"adi\"\n"
+      "diffusion_substeps = 4\n"
       "\n"
       "[visualization]\n"
       "live = false\n"
@@ -64,8 +67,19 @@ class SimulationTest : public ::testing::Test {
       "\n"
       "[performance]\n"
       "scheduling_batch_size = 123\n"
+      "so_sort_frequency = 5\n"
       "detect_static_sim_objects = true\n"
       "cache_neighbors = true\n"
+      "incremental_grid_update = true\n"
+      "sorted_cell_list = true\n"
+      "grid_box_length = 12\n"
+      "grid_search_radius = 3.5\n"
+      "verlet_skin = 1.5\n"
+      "symmetric_displacement = true\n"
+      "box_coloring = true\n"
+      "fuse_diffusion_grids = true\n"
+      "sparse_diffusion = true\n"
+      "sparse_diffusion_threshold = 1e-9\n"
       "\n"
       "[development]\n"
       "# this is a comment\n"
@@ -104,6 +118,9 @@ class SimulationTest : public ::testing::Test {
     EXPECT_TRUE(param->bound_space_);
     EXPECT_EQ(-100, param->min_bound_);
     EXPECT_EQ(200, param->max_bound_);
+    EXPECT_TRUE(param->periodic_boundary_);
+    EXPECT_EQ("adi", param->diffusion_method_);
+    EXPECT_EQ(4u, param->diffusion_substeps_);
     EXPECT_FALSE(param->live_visualization_);
     EXPECT_TRUE(param->export_visualization_);
     EXPECT_EQ(100u, param->visualization_export_interval_);
@@ -145,8 +162,19 @@ class SimulationTest : public ::testing::Test {
 
     // performance group
     EXPECT_EQ(123u, param->scheduling_batch_size_);
+    EXPECT_EQ(5u, param->so_sort_frequency_);
     EXPECT_TRUE(param->detect_static_sim_objects_);
     EXPECT_TRUE(param->cache_neighbors_);
+    EXPECT_TRUE(param->incremental_grid_update_);
+    EXPECT_TRUE(param->sorted_cell_list_);
+    EXPECT_EQ(12u, param->grid_box_length_);
+    EXPECT_EQ(3.5, param->grid_search_radius_);
+    EXPECT_EQ(1.5, param->verlet_skin_);
+    EXPECT_TRUE(param->symmetric_displacement_);
+    EXPECT_TRUE(param->box_coloring_);
+    EXPECT_TRUE(param->fuse_diffusion_grids_);
+    EXPECT_TRUE(param->sparse_diffusion_);
+    EXPECT_EQ(1e-9, param->sparse_diffusion_threshold_);
 
     // development group
     EXPECT_TRUE(param->statistics_);
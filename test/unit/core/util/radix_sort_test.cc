@@ -0,0 +1,52 @@
+// -----------------------------------------------------------------------------
+//
+// Copyright (C) The BioDynaMo Project.
+// All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+//
+// See the LICENSE file distributed with this work for details.
+// See the NOTICE file distributed with this work for additional information
+// regarding copyright ownership.
+//
+// -----------------------------------------------------------------------------
+
+#include "core/util/radix_sort.h"
+#include <random>
+#include <utility>
+#include "gtest/gtest.h"
+
+namespace bdm {
+
+TEST(RadixSortTest, SortsAndIsStable) {
+  std::mt19937_64 generator(42);
+  const uint32_t key_bits = 42;
+  std::uniform_int_distribution<uint64_t> distribution(0, (1ull << 10) - 1);
+
+  // <key, original position>; many duplicate keys to test stability
+  std::vector<std::pair<uint64_t, uint64_t>> data(100000);
+  for (uint64_t i = 0; i < data.size(); i++) {
+    data[i] = {distribution(generator) << (key_bits - 10), i};
+  }
+  auto expected = data;
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const auto& lhs, const auto& rhs) {
+                     return lhs.first < rhs.first;
+                   });
+
+  std::vector<std::pair<uint64_t, uint64_t>> buffer;
+  ParallelRadixSort(&data, &buffer, key_bits,
+                    [](const auto& pair) { return pair.first; });
+
+  EXPECT_EQ(expected, data);
+}
+
+TEST(RadixSortTest, Empty) {
+  std::vector<uint64_t> data;
+  std::vector<uint64_t> buffer;
+  ParallelRadixSort(&data, &buffer, 64, [](uint64_t el) { return el; });
+  EXPECT_EQ(0u, data.size());
+}
+
+}  // namespace bdm
@@ -30,7 +30,9 @@ void RunAllChecks(const ThreadInfo& ti) {
 #pragma omp critical
     {
       int tid = omp_get_thread_num();
-      auto nid = numa_node_of_cpu(sched_getcpu());
+      // without thread binding, the mapping does not reflect the cpu
+      auto nid = ti.ThreadsArePinned() ? numa_node_of_cpu(sched_getcpu())
+                                       : ti.GetNumaNode(tid);
       // check if mappting openmp thread id to numa node is correct
       EXPECT_EQ(nid, ti.GetNumaNode(tid));
       auto numa_thread_id = ti.GetNumaThreadId(tid);